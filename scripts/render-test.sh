@@ -0,0 +1,37 @@
+#!/bin/sh
+# Software-renders the intro, game and game-over scenes and compares each frame with
+# the reference in bin/data/render-reference; exits 1 if any differs. The frames come
+# from --render-test, so no window or GL context is needed.
+#
+#   scripts/render-test.sh [app binary]            compare (default bin/<project>)
+#   scripts/render-test.sh --update [app binary]   re-record the references
+#
+# Re-record only after a change that is meant to alter the frames, and commit the new
+# references with it. Failed frames are kept in bin/data/render-out for a look.
+cd "$(dirname "$0")/.." || exit 1
+root=$(pwd)
+update=0
+if [ "$1" = "--update" ]; then
+    update=1
+    shift
+fi
+app=${1:-bin/$(basename "$root")}
+if [ ! -x "$app" ]; then
+    echo "no app binary at $app; build the project first or pass its path" >&2
+    exit 1
+fi
+
+references="$root/bin/data/render-reference"
+out="$root/bin/data/render-out"
+mkdir -p "$out"
+status=0
+for scene in intro game game-over; do
+    if [ "$update" = 1 ]; then
+        "$app" --render-test "$scene" "$references/$scene.png" || status=1
+    elif "$app" --render-test "$scene" "$out/$scene.png" "$references/$scene.png"; then
+        rm -f "$out/$scene.png"
+    else
+        status=1
+    fi
+done
+exit $status
@@ -1,4 +1,8 @@
 #include "Aquarium.h"
+#include "Collision.h"
+#include "MemoryStats.h"
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
 
 
@@ -28,19 +32,23 @@ PlayerCreature::PlayerCreature(float x, float y, int speed, std::shared_ptr<Game
     m_normalSprite = sprite;
 }
 
-void PlayerCreature::update() {
-    this->reduceDamageDebounce();
-    float deltaTime = ofGetLastFrameTime();
-    updateBoost(deltaTime);
-    updatePredator(deltaTime);
-    reduceDamageDebounce();
-    move();
+PlayerCreature::~PlayerCreature() {
+    setTimers(nullptr); // nothing may call back into a destroyed player
 }
 
-void PlayerCreature::setDirection(float dx, float dy) {
-    m_dx = dx;
-    m_dy = dy;
-    normalize();
+void PlayerCreature::setTimers(std::shared_ptr<TimerWheel> timers) {
+    if (m_timers == timers) return;
+    if (m_timers) {
+        for (TimerId& id : m_boostTimers) m_timers->cancel(id);
+        m_timers->cancel(m_predatorTimer);
+        m_timers->cancel(m_damageDebounceTimer);
+    }
+    m_timers = std::move(timers);
+}
+
+// boosts, predator mode and the damage debounce expire on the aquarium clock
+void PlayerCreature::update() {
+    move();
 }
 
 void PlayerCreature::move() {
@@ -49,22 +57,11 @@ void PlayerCreature::move() {
     this->bounce();
 }
 
-void PlayerCreature::reduceDamageDebounce() {
-    if (m_damage_debounce > 0) {
-        --m_damage_debounce;
-    }
-}
-
 void PlayerCreature::startBoost(PowerUpType type) {
     startBoost(5.0f, type);
 }
 
 void PlayerCreature::startBoost(float seconds, PowerUpType type) {
-    m_boosted = true;
-    m_hasActiveBoost = true;
-    m_currentBoostType = type;
-    m_boostTimer = seconds;
-
     auto scene = dynamic_cast<AquariumGameScene*>(ofGetAppPtr());
 
     if (type == PowerUpType::SPEED) {
@@ -96,45 +93,37 @@ void PlayerCreature::startBoost(float seconds, PowerUpType type) {
             scene->showBoostMessage("SIZE BOOST!");
         }
     }
-}
-
-
-void PlayerCreature::updateBoost(float deltaTime) {
-    if (!m_hasActiveBoost) return;
-
-    m_boostTimer -= deltaTime;
-    if (m_boostTimer <= 0.0f) {
-        if (m_currentBoostType == PowerUpType::SPEED) {
-            m_speed = m_baseSpeed;
-            ofLogNotice() << "Power-up expired. Speed reset to " << m_baseSpeed;
-        } else if (m_currentBoostType == PowerUpType::SIZE) {
-            m_sizeBoostMultiplier = 1.0f;
-            float baseRadius = m_inPredatorMode ? m_predatorCollisionRadius : m_baseRadius;
-            setCollisionRadius(baseRadius);
-            ofLogNotice() << "Size boost expired. Hitbox reset.";
-        }
 
-        m_boosted = false;
-        m_hasActiveBoost = false;
-    }
+    // collecting the same type again restarts its clock; other types keep theirs
+    if (!m_timers) return;
+    TimerId& timer = m_boostTimers[static_cast<int>(type)];
+    m_timers->cancel(timer);
+    timer = m_timers->schedule(seconds, [this, type]() { endBoost(type); });
 }
 
-void PlayerCreature::updatePredator(float deltaTime) {
-    if (!m_inPredatorMode) {
-        return;
-    }
-
-    m_predatorTimer = std::max(0.0f, m_predatorTimer - deltaTime);
-    if (ofGetElapsedTimef() >= m_predatorEndTime) {
-        ofLogNotice() << "Predator mode expired.";
-        deactivatePredatorMode();
+void PlayerCreature::endBoost(PowerUpType type) {
+    m_boostTimers[static_cast<int>(type)] = TimerId();
+    if (type == PowerUpType::SPEED) {
+        m_speed = m_baseSpeed;
+        ofLogNotice() << "Power-up expired. Speed reset to " << m_baseSpeed;
+    } else if (type == PowerUpType::SIZE) {
+        m_sizeBoostMultiplier = 1.0f;
+        float baseRadius = m_inPredatorMode ? m_predatorCollisionRadius : m_baseRadius;
+        setCollisionRadius(baseRadius);
+        ofLogNotice() << "Size boost expired. Hitbox reset.";
     }
 }
 
 void PlayerCreature::activatePredatorMode(float seconds, std::shared_ptr<GameSprite> predatorSprite) {
     m_inPredatorMode = true;
-    m_predatorTimer = seconds;
-    m_predatorEndTime = ofGetElapsedTimef() + seconds;
+    if (m_timers) {
+        m_timers->cancel(m_predatorTimer);
+        m_predatorTimer = m_timers->schedule(seconds, [this]() {
+            m_predatorTimer = TimerId();
+            ofLogNotice() << "Predator mode expired.";
+            deactivatePredatorMode();
+        });
+    }
 
     if (!m_normalSprite) {
         m_normalSprite = m_sprite;
@@ -151,8 +140,7 @@ void PlayerCreature::activatePredatorMode(float seconds, std::shared_ptr<GameSpr
 
 void PlayerCreature::deactivatePredatorMode() {
     m_inPredatorMode = false;
-    m_predatorTimer = 0.0f;
-    m_predatorEndTime = 0.0f;
+    if (m_timers) m_timers->cancel(m_predatorTimer);
 
     if (m_normalSprite) {
         setSprite(m_normalSprite);
@@ -164,13 +152,13 @@ void PlayerCreature::deactivatePredatorMode() {
 void PlayerCreature::draw() const {
     
     ofLogVerbose() << "PlayerCreature at (" << m_x << ", " << m_y << ") with speed " << m_speed << std::endl;
-    if (this->m_damage_debounce > 0) {
-        ofSetColor(ofColor::red); // Flash red if in damage debounce
+    SpriteRenderState state = m_renderState;
+    if (this->isDamageDebounced()) {
+        state.tint = ofColor::red; // Flash red if in damage debounce
     }
     if (m_sprite) {
-        m_sprite->draw(m_x, m_y);
+        m_sprite->draw(m_x, m_y, state);
     }
-    ofSetColor(ofColor::white); // Reset color
 
 }
 
@@ -178,158 +166,155 @@ void PlayerCreature::changeSpeed(int speed) {
     m_speed = speed;
 }
 
-void PlayerCreature::loseLife(int debounce) {
-    if (m_damage_debounce <= 0) {
+bool PlayerCreature::loseLife(int debounceTicks) {
+    if (!isDamageDebounced()) {
         if (m_lives > 0) this->m_lives -= 1;
-        m_damage_debounce = debounce; // Set debounce frames
+        if (m_timers) {
+            m_damageDebounceTimer = m_timers->scheduleTicks(debounceTicks, [this]() { m_damageDebounceTimer = TimerId(); });
+        }
         ofLogNotice() << "Player lost a life! Lives remaining: " << m_lives << std::endl;
-    }
-    // If in debounce period, do nothing
-    if (m_damage_debounce > 0) {
-        ofLogVerbose() << "Player is in damage debounce period. Frames left: " << m_damage_debounce << std::endl;
+        return true;
+    } else {
+        // If in debounce period, do nothing
+        ofLogVerbose() << "Player is in damage debounce period. Seconds left: " << m_timers->getRemaining(m_damageDebounceTimer) << std::endl;
+        return false;
     }
 }
 
 // NPCreature Implementation
+// heading is picked by Aquarium::SpawnCreature from the aquarium's own rng
 NPCreature::NPCreature(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
 : Creature(x, y, speed, 30, 1, sprite) {
-    m_dx = (rand() % 3 - 1); // -1, 0, or 1
-    m_dy = (rand() % 3 - 1); // -1, 0, or 1
-    normalize();
-
     m_creatureType = AquariumCreatureType::NPCreature;
+    std::pair<int, int> size = AquariumSpriteManager::GetSpriteSize(m_creatureType);
+    setHitboxSize(size.first, size.second);
 }
 
 void NPCreature::move() {
-    // Simple AI movement logic (random direction)
-    m_x += m_dx * m_speed;
-    m_y += m_dy * m_speed;
-    if(m_dx < 0 ){
-        this->m_sprite->setFlipped(true);
-    }else {
-        this->m_sprite->setFlipped(false);
-    }
-    bounce();
+    CreatureBehavior<AquariumCreatureType::NPCreature>::move(*this, FlowCell());
 }
 
 void NPCreature::draw() const {
     ofLogVerbose() << "NPCreature at (" << m_x << ", " << m_y << ") with speed " << m_speed << std::endl;
-    ofSetColor(ofColor::white);
+    RenderSetColor(ofColor::white);
     if (m_sprite) {
-        m_sprite->draw(m_x, m_y);
+        m_sprite->draw(m_x, m_y, m_renderState);
     }
 }
 
 
 BiggerFish::BiggerFish(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
 : NPCreature(x, y, speed, sprite) {
-    m_dx = (rand() % 3 - 1);
-    m_dy = (rand() % 3 - 1);
-    normalize();
-
     setCollisionRadius(60); // Bigger fish have a larger collision radius
     m_value = 5; // Bigger fish have a higher value
     m_creatureType = AquariumCreatureType::BiggerFish;
+    std::pair<int, int> size = AquariumSpriteManager::GetSpriteSize(m_creatureType);
+    setHitboxSize(size.first, size.second);
 }
 
 void BiggerFish::move() {
     // Bigger fish might move slower or have different logic
-    m_x += m_dx * (m_speed * 0.5); // Moves at half speed
-    m_y += m_dy * (m_speed * 0.5);
-    if(m_dx < 0 ){
-        this->m_sprite->setFlipped(true);
-    }else {
-        this->m_sprite->setFlipped(false);
-    }
-
-    bounce();
+    CreatureBehavior<AquariumCreatureType::BiggerFish>::move(*this, FlowCell(), false);
 }
 
 void BiggerFish::draw() const {
     ofLogVerbose() << "BiggerFish at (" << m_x << ", " << m_y << ") with speed " << m_speed << std::endl;
-    this->m_sprite->draw(this->m_x, this->m_y);
-}
-
-class Axolotl : public NPCreature {
-public:
-    Axolotl(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
-        : NPCreature(x, y, speed, sprite) {
-        m_dx = 1;      
-        m_dy = 0;      
-        normalize();
-
-        setCollisionRadius(40); 
-        m_value = 3;   
-        m_creatureType = AquariumCreatureType::Axolotl;
+    if (m_sprite) {
+        m_sprite->draw(m_x, m_y, m_renderState);
     }
+}
 
-    void move() override {
-        m_x += m_dx * m_speed;
+Axolotl::Axolotl(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
+: NPCreature(x, y, speed, sprite) {
+    m_dx = 1;
+    m_dy = 0;
+    normalize();
 
-        if (m_x <= 0 || m_x >= m_width) {
-            m_dx = -m_dx;
-            if (m_sprite) m_sprite->setFlipped(m_dx < 0);
-        }
+    m_value = 3;
+    m_creatureType = AquariumCreatureType::Axolotl;
+    // long and flat: a capsule along the body rather than one circle as wide as it is long
+    std::pair<int, int> size = AquariumSpriteManager::GetSpriteSize(m_creatureType);
+    setHitboxSize(size.first, size.second);
+    setCollisionRadius(size.second * 0.5f);
+    setCapsuleHalfLength((size.first - size.second) * 0.5f);
+}
 
-    }
+void Axolotl::move() {
+    CreatureBehavior<AquariumCreatureType::Axolotl>::move(*this, FlowCell());
+}
 
-    void draw() const override {
-        if (m_sprite) {
-            m_sprite->draw(m_x, m_y);
-        }
+void Axolotl::draw() const {
+    if (m_sprite) {
+        m_sprite->draw(m_x, m_y, m_renderState);
     }
-};
-
-class Jellyfish : public NPCreature {
-public:
-    Jellyfish(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
-        : NPCreature(x, y, speed, sprite)
-    {
-        m_dx = 0;
-        m_dy = 1;
-        normalize();
+}
 
-        setCollisionRadius(30);
-        m_value = 2;
-        m_creatureType = AquariumCreatureType::Jellyfish;
-    }
+Jellyfish::Jellyfish(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
+: NPCreature(x, y, speed, sprite) {
+    m_dx = 0;
+    m_dy = 1;
+    normalize();
 
-    void move() override {
-        m_y += m_dy * m_speed;
+    setCollisionRadius(30);
+    m_value = 2;
+    m_creatureType = AquariumCreatureType::Jellyfish;
+    std::pair<int, int> size = AquariumSpriteManager::GetSpriteSize(m_creatureType);
+    setHitboxSize(size.first, size.second);
+}
 
-        if (m_y <= 0 || m_y >= m_height) {
-            m_dy = -m_dy;
-        }
-    }
+void Jellyfish::move() {
+    CreatureBehavior<AquariumCreatureType::Jellyfish>::move(*this, FlowCell());
+}
 
-    void draw() const override {
-        if (m_sprite) {
-            m_sprite->draw(m_x, m_y);
-        }
+void Jellyfish::draw() const {
+    if (m_sprite) {
+        m_sprite->draw(m_x, m_y, m_renderState);
     }
-};
+}
 
 // AquariumSpriteManager
-AquariumSpriteManager::AquariumSpriteManager(){
-    this->m_npc_fish = std::make_shared<GameSprite>("base-fish.png", 70,70);
-    this->m_big_fish = std::make_shared<GameSprite>("bigger-fish.png", 120, 120);
-    this->m_axolotl = std::make_shared<GameSprite>("axolotl.png", 80, 50);
-    this->m_jellyfish = std::make_shared<GameSprite>("jellyfish.png", 60, 80);
+// headless managers (simulation shards, CI) skip image loading and hand out null sprites
+AquariumSpriteManager::AquariumSpriteManager(bool loadImages){
+    if(!loadImages){return;}
+    auto load = [](const std::string& path, AquariumCreatureType t) {
+        std::pair<int, int> size = GetSpriteSize(t);
+        return std::make_shared<GameSprite>(path, size.first, size.second);
+    };
+    this->m_npc_fish = load("base-fish.png", AquariumCreatureType::NPCreature);
+    this->m_big_fish = load("bigger-fish.png", AquariumCreatureType::BiggerFish);
+    this->m_axolotl = load("axolotl.png", AquariumCreatureType::Axolotl);
+    this->m_jellyfish = load("jellyfish.png", AquariumCreatureType::Jellyfish);
+}
+
+std::pair<int, int> AquariumSpriteManager::GetSpriteSize(AquariumCreatureType t){
+    switch(t){
+        case AquariumCreatureType::BiggerFish:
+            return {120, 120};
+        case AquariumCreatureType::Axolotl:
+            return {80, 50};
+        case AquariumCreatureType::Jellyfish:
+            return {60, 80};
+        case AquariumCreatureType::NPCreature:
+        default:
+            return {70, 70};
+    }
 }
 
+// sprites are immutable and shared; flip and tint live on each creature
 std::shared_ptr<GameSprite> AquariumSpriteManager::GetSprite(AquariumCreatureType t){
+    if(this->isHeadless()){return nullptr;}
     switch(t){
         case AquariumCreatureType::BiggerFish:
-            return this->m_big_fish->clone();
+            return this->m_big_fish;
             
         case AquariumCreatureType::NPCreature:
-            return this->m_npc_fish->clone();
+            return this->m_npc_fish;
 
         case AquariumCreatureType::Axolotl:
-            return this->m_axolotl->clone();
+            return this->m_axolotl;
         
         case AquariumCreatureType::Jellyfish:
-            return this->m_jellyfish->clone();
+            return this->m_jellyfish;
 
         default:
             return nullptr;
@@ -341,33 +326,207 @@ std::shared_ptr<GameSprite> AquariumSpriteManager::GetSprite(AquariumCreatureTyp
 Aquarium::Aquarium(int width, int height, std::shared_ptr<AquariumSpriteManager> spriteManager)
     : m_width(width), m_height(height) {
         m_sprite_manager =  spriteManager;
+        m_flowField.resize(width, height);
+        m_chunks.resize(width, height);
+        m_schoolingSettings[static_cast<int>(AquariumCreatureType::NPCreature)].enabled = true; // small fish school
+        for (auto& pool : m_creaturePools) {
+            pool = std::make_shared<CreaturePool>();
+        }
+    }
+
+// everything already in the tank gets the new bounds too, not just later spawns
+void Aquarium::setBounds(int w, int h) {
+    m_width = w;
+    m_height = h;
+    m_flowField.resize(w, h);
+    m_chunks.resize(w, h); // everything is active again until the next setActiveArea
+    for (const auto& creature : m_creatures) {
+        creature->setBounds(m_width - 20, m_height - 20);
     }
+    for (const auto& weakPlayer : m_players) {
+        if (auto player = weakPlayer.lock()) player->setBounds(m_width - 20, m_height - 20);
+    }
+}
 
 
 
+void Aquarium::setActiveArea(float x, float y, float width, float height) {
+    m_viewX = x;
+    m_viewY = y;
+    m_viewWidth = width;
+    m_viewHeight = height;
+    if (m_chunks.setView(x, y, width, height)) m_chunksChanged = true;
+}
+
+void Aquarium::setPlayer(std::shared_ptr<PlayerCreature> player) {
+    m_players.clear();
+    if (player) addPlayer(player);
+}
+
+void Aquarium::addPlayer(std::shared_ptr<PlayerCreature> player) {
+    m_players.push_back(player);
+    player->setTimers(m_timers);
+}
+
+void Aquarium::removePlayer(std::shared_ptr<PlayerCreature> player) {
+    m_players.erase(std::remove_if(m_players.begin(), m_players.end(), [&](const std::weak_ptr<PlayerCreature>& other) {
+        return other.expired() || other.lock() == player;
+    }), m_players.end());
+    player->setTimers(nullptr); // pending boosts die with the player
+}
+
+bool Aquarium::hasPlayer() const {
+    for (const auto& player : m_players) {
+        if (!player.expired()) return true;
+    }
+    return false;
+}
+
 void Aquarium::addCreature(std::shared_ptr<Creature> creature) {
+    MemoryScope memory(MemoryTag::CREATURES); // bucket growth
     creature->setBounds(m_width - 20, m_height - 20);
+    creature->setLastSimTick(m_simTick); // nothing owed from before it existed
+    creature->setId(++m_nextCreatureId);
+    auto npc = std::dynamic_pointer_cast<NPCreature>(creature);
+    if (npc) {
+        m_creatureBuckets[static_cast<int>(npc->GetType())].push_back(creature.get());
+    } else {
+        m_otherCreatures.push_back(creature.get());
+    }
     m_creatures.push_back(creature);
 }
 
 void Aquarium::addAquariumLevel(std::shared_ptr<AquariumLevel> level){
+    MemoryScope memory(MemoryTag::LEVELS);
     if(level == nullptr){return;} // guard to not add noise
     this->m_aquariumlevels.push_back(level);
 }
 
 void Aquarium::update() {
-    for (auto& creature : m_creatures) {
-        creature->move();
+    {
+        FlightZoneTimer zone(m_recorder, FlightZone::STREAM);
+        this->streamChunks();
     }
+    {
+        FlightZoneTimer zone(m_recorder, FlightZone::FLOW_FIELD);
+        this->updateFlowField();
+    }
+    {
+        FlightZoneTimer zone(m_recorder, FlightZone::MOVE);
+        this->moveCreatures();
+    }
+    FlightZoneTimer zone(m_recorder, FlightZone::REPOPULATE);
     this->Repopulate();
 }
 
+// one field per tick around the player and the bigger fish; NPCs sample it in moveCreatures
+// with several players the field leads to the nearest one, and any player in predator mode flips it
+void Aquarium::updateFlowField() {
+    m_playerCenters.clear();
+    bool predatorMode = false;
+    for (const auto& weakPlayer : m_players) {
+        auto player = weakPlayer.lock();
+        if (!player) continue;
+        m_playerCenters.push_back(glm::vec2(player->getCenterX(), player->getCenterY()));
+        predatorMode = predatorMode || player->isPredatorMode();
+    }
+    if (m_playerCenters.empty()) {
+        m_flowField.clear();
+        return;
+    }
+    m_flowField.rebuild(m_playerCenters.data(), static_cast<int>(m_playerCenters.size()), predatorMode,
+                        m_creatureBuckets[static_cast<int>(AquariumCreatureType::BiggerFish)]);
+}
+
+// NPCs move through their static behaviors one type at a time; see CreatureBehavior.h
+// Only the creatures the LOD marks as due move (and school) this tick; without a
+// player to measure distance from, everything is due.
+void Aquarium::moveCreatures() {
+    ++m_simTick;
+    const CreatureBuckets* moving = &m_creatureBuckets;
+    if (m_lod.enabled && m_lod.farInterval > 1 && this->hasPlayer()) {
+        SelectDueCreatures(m_creatureBuckets, m_flowField, m_lod, m_simTick, m_dueBuckets);
+        moving = &m_dueBuckets;
+    }
+    m_activeCreatures = static_cast<int>(m_otherCreatures.size());
+    for (int t = 0; t < AQUARIUM_CREATURE_TYPE_COUNT; ++t) {
+        m_schooling[t].update((*moving)[t], m_schoolingSettings[t], m_chunks.getActiveX(), m_chunks.getActiveY(),
+                              static_cast<int>(m_chunks.getActiveWidth()), static_cast<int>(m_chunks.getActiveHeight()), m_pool);
+        m_activeCreatures += static_cast<int>((*moving)[t].size());
+    }
+    MoveCreatureBuckets(*moving, m_flowField, m_simTick);
+    for (Creature* creature : m_otherCreatures) {
+        creature->move();
+    }
+}
+
+// the margin chunks are simulated but off screen, so only what overlaps the view is drawn
 void Aquarium::draw() const {
+    const float margin = 100.0f; // more than half the largest sprite
     for (const auto& creature : m_creatures) {
+        if (m_viewWidth > 0.0f
+            && (creature->getCenterX() < m_viewX - margin || creature->getCenterX() > m_viewX + m_viewWidth + margin
+                || creature->getCenterY() < m_viewY - margin || creature->getCenterY() > m_viewY + m_viewHeight + margin)) {
+            continue;
+        }
         creature->draw();
     }
 }
 
+// Creatures that swam out of the active chunks are paged out to compact records and
+// hand their level slot back, so the level respawns around the camera instead; when
+// the active chunks move, whatever was left in the newly active ones is rebuilt and
+// takes its slot again. Records only wake into free slots (before Repopulate gets
+// them), so a revisited area never pushes the tank over the level's population.
+// Waking is only retried when the chunks move or a slot frees up, and each type keeps
+// at most its level population in records, the oldest dropped first.
+void Aquarium::streamChunks() {
+    MemoryScope memory(MemoryTag::CREATURES); // dormant records and woken creatures
+    if (m_aquariumlevels.empty()) return;
+    std::shared_ptr<AquariumLevel> level = m_aquariumlevels.at(currentLevel % m_aquariumlevels.size());
+    for (auto it = m_creatures.begin(); it != m_creatures.end();) {
+        auto npc = std::dynamic_pointer_cast<NPCreature>(*it);
+        if (!npc || m_chunks.isActive(npc->getCenterX(), npc->getCenterY())) {
+            ++it;
+            continue;
+        }
+        DormantCreature record;
+        record.x = npc->getCenterX();
+        record.y = npc->getCenterY();
+        record.dx = npc->getDx();
+        record.dy = npc->getDy();
+        record.speed = static_cast<int16_t>(npc->getSpeed());
+        record.type = static_cast<uint8_t>(npc->GetType());
+        m_chunks.store(record);
+        m_chunks.trimType(record.type, static_cast<size_t>(level->getPopulation(npc->GetType())));
+        level->ReleasePopulation(npc->GetType());
+        m_wakePending = true; // the freed slot may belong to a record in view
+        it = this->detachCreature(it);
+    }
+
+    if (m_chunksChanged) {
+        m_chunksChanged = false;
+        m_wakePending = true;
+        m_flowField.setRegion(static_cast<int>(m_chunks.getActiveX()), static_cast<int>(m_chunks.getActiveY()),
+                              static_cast<int>(m_chunks.getActiveWidth()), static_cast<int>(m_chunks.getActiveHeight()));
+    }
+    if (!m_wakePending) return;
+    m_wakePending = false;
+    m_wokenCreatures.clear();
+    // records without a free slot stay paged out until the next freed slot or move
+    m_chunks.takeActive(m_wokenCreatures, [&](const DormantCreature& record) {
+        return level->ClaimPopulation(static_cast<AquariumCreatureType>(record.type));
+    });
+    for (const DormantCreature& record : m_wokenCreatures) {
+        auto type = static_cast<AquariumCreatureType>(record.type);
+        std::pair<int, int> size = AquariumSpriteManager::GetSpriteSize(type);
+        auto npc = this->createCreature(type, record.x - size.first * 0.5f, record.y - size.second * 0.5f, record.speed);
+        if (!npc) { level->ReleasePopulation(type); continue; }
+        npc->setDirection(record.dx, record.dy);
+        this->addCreature(npc);
+    }
+}
+
 
 void Aquarium::removeCreature(std::shared_ptr<Creature> creature) {
     auto it = std::find(m_creatures.begin(), m_creatures.end(), creature);
@@ -376,12 +535,55 @@ void Aquarium::removeCreature(std::shared_ptr<Creature> creature) {
         int selectLvl = this->currentLevel % this->m_aquariumlevels.size();
         auto npcCreature = std::static_pointer_cast<NPCreature>(creature);
         this->m_aquariumlevels.at(selectLvl)->ConsumePopulation(npcCreature->GetType(), npcCreature->getValue());
-        m_creatures.erase(it);
+        this->detachCreature(it);
+        m_wakePending = true; // a record in view gets the slot before Repopulate does
+    }
+}
+
+std::vector<std::shared_ptr<Creature>>::iterator Aquarium::detachCreature(std::vector<std::shared_ptr<Creature>>::iterator it) {
+    auto npc = std::dynamic_pointer_cast<NPCreature>(*it);
+    std::vector<Creature*>& bucket = npc ? m_creatureBuckets[static_cast<int>(npc->GetType())] : m_otherCreatures;
+    auto slot = std::find(bucket.begin(), bucket.end(), it->get());
+    if (slot != bucket.end()) bucket.erase(slot);
+    return m_creatures.erase(it);
+}
+
+// the governor lowered the cap: drop the newest NPCs and hand their slots back to the
+// level unscored, so they respawn once the cap is raised again
+void Aquarium::cullToMaxPopulation() {
+    if (m_maxPopulation <= 0 || m_aquariumlevels.empty()) return;
+    std::shared_ptr<AquariumLevel> level = m_aquariumlevels.at(currentLevel % m_aquariumlevels.size());
+    while (static_cast<int>(m_creatures.size()) > m_maxPopulation) {
+        auto it = std::prev(m_creatures.end());
+        auto npc = std::dynamic_pointer_cast<NPCreature>(*it);
+        if (npc) level->ReleasePopulation(npc->GetType());
+        this->detachCreature(it);
     }
 }
 
+int Aquarium::getLevelPopulation() const {
+    if (m_aquariumlevels.empty()) return 0;
+    return m_aquariumlevels.at(currentLevel % m_aquariumlevels.size())->getTotalPopulation();
+}
+
 void Aquarium::clearCreatures() {
+    for (auto& bucket : m_creatureBuckets) {
+        bucket.clear();
+    }
+    m_otherCreatures.clear();
     m_creatures.clear();
+    m_chunks.clear(); // paged-out creatures belong to the old population too
+}
+
+// back to the first level with a fresh population, used when a headless run hits game over
+void Aquarium::reset() {
+    for(auto level : this->m_aquariumlevels){
+        level->levelReset();
+    }
+    this->currentLevel = 0;
+    this->m_simTick = 0; // LOD phases restart with the population
+    this->clearCreatures();
+    this->Repopulate();
 }
 
 std::shared_ptr<Creature> Aquarium::getCreatureAt(int index) {
@@ -393,29 +595,48 @@ std::shared_ptr<Creature> Aquarium::getCreatureAt(int index) {
 
 
 
+// spawns land in the active chunks, off screen when a few tries allow it so nothing pops in under the camera
 void Aquarium::SpawnCreature(AquariumCreatureType type) {
-    int x = rand() % this->getWidth();
-    int y = rand() % this->getHeight();
-    int speed = 1 + rand() % 25; // Speed between 1 and 25
+    // every aquarium draws from its own rng so shards stay independent and reproducible
+    int left = static_cast<int>(m_chunks.getActiveX()), top = static_cast<int>(m_chunks.getActiveY());
+    std::uniform_int_distribution<int> column(left, left + static_cast<int>(m_chunks.getActiveWidth()) - 1);
+    std::uniform_int_distribution<int> row(top, top + static_cast<int>(m_chunks.getActiveHeight()) - 1);
+    int x = column(m_rng);
+    int y = row(m_rng);
+    for (int attempt = 0; attempt < 4 && m_viewWidth > 0.0f
+         && x >= m_viewX && x < m_viewX + m_viewWidth && y >= m_viewY && y < m_viewY + m_viewHeight; ++attempt) {
+        x = column(m_rng);
+        y = row(m_rng);
+    }
+    int speed = std::uniform_int_distribution<int>(1, 25)(m_rng); // Speed between 1 and 25
+    std::uniform_int_distribution<int> heading(-1, 1); // -1, 0, or 1
+
+    auto creature = this->createCreature(type, x, y, speed);
+    if (!creature) return;
+    if (type == AquariumCreatureType::NPCreature || type == AquariumCreatureType::BiggerFish) {
+        creature->setDirection(heading(m_rng), heading(m_rng));
+    }
+    this->addCreature(creature);
+}
 
+std::shared_ptr<NPCreature> Aquarium::createCreature(AquariumCreatureType type, float x, float y, int speed) {
+    MemoryScope memory(MemoryTag::CREATURES);
+    std::shared_ptr<GameSprite> sprite = this->m_sprite_manager->GetSprite(type);
+    // each type comes from its own pool, so its bucket is contiguous in memory
+    const std::shared_ptr<CreaturePool>& pool = m_creaturePools[static_cast<int>(type)];
     switch (type) {
         case AquariumCreatureType::NPCreature:
-            this->addCreature(std::make_shared<NPCreature>(x, y, speed, this->m_sprite_manager->GetSprite(AquariumCreatureType::NPCreature)));
-            break;
+            return std::allocate_shared<NPCreature>(CreaturePoolAllocator<NPCreature>(pool), x, y, speed, sprite);
         case AquariumCreatureType::BiggerFish:
-            this->addCreature(std::make_shared<BiggerFish>(x, y, speed, this->m_sprite_manager->GetSprite(AquariumCreatureType::BiggerFish)));
-            break;
+            return std::allocate_shared<BiggerFish>(CreaturePoolAllocator<BiggerFish>(pool), x, y, speed, sprite);
         case AquariumCreatureType::Axolotl:
-            this->addCreature(std::make_shared<Axolotl>(x, y, speed, this->m_sprite_manager->GetSprite(AquariumCreatureType::Axolotl)));
-            break;
+            return std::allocate_shared<Axolotl>(CreaturePoolAllocator<Axolotl>(pool), x, y, speed, sprite);
         case AquariumCreatureType::Jellyfish:
-            this->addCreature(std::make_shared<Jellyfish>(x, y, speed, this->m_sprite_manager->GetSprite(AquariumCreatureType::Jellyfish)));
-            break;
+            return std::allocate_shared<Jellyfish>(CreaturePoolAllocator<Jellyfish>(pool), x, y, speed, sprite);
         default:
             ofLogError() << "Unknown creature type to spawn!";
-            break;
+            return nullptr;
     }
-
 }
 
 int Aquarium::getCurrentLevel() const {
@@ -453,172 +674,487 @@ void Aquarium::Repopulate() {
     // now lets find how many to respawn if needed 
     std::vector<AquariumCreatureType> toRespawn = level->Repopulate();
     ofLogVerbose() << "amount to repopulate : " << toRespawn.size() << endl;
-    if(toRespawn.size() <= 0 ){return;} // there is nothing for me to do here
+    if(toRespawn.size() <= 0 ){this->cullToMaxPopulation(); return;} // there is nothing for me to do here
     for(AquariumCreatureType newCreatureType : toRespawn){
+        if (m_maxPopulation > 0 && this->getCreatureCount() >= m_maxPopulation) {
+            level->ReleasePopulation(newCreatureType); // over the cap, try again next repopulation
+            continue;
+        }
         this->SpawnCreature(newCreatureType);
     }
+    this->cullToMaxPopulation();
 }
 
 
+// every GameEvent the rules hand out is charged to the events tag
+static std::shared_ptr<GameEvent> makeEvent(GameEventType type, std::shared_ptr<Creature> a, std::shared_ptr<Creature> b) {
+    MemoryScope memory(MemoryTag::EVENTS);
+    return std::make_shared<GameEvent>(type, std::move(a), std::move(b));
+}
+
 // Aquarium collision detection
-std::shared_ptr<GameEvent> DetectAquariumCollisions(std::shared_ptr<Aquarium> aquarium, std::shared_ptr<PlayerCreature> player) {
+// Checks run only every few frames, so each test sweeps the player and the NPC
+// along their motion since the previous check instead of comparing end positions;
+// fast fish can no longer pass through the player between checks. Every creature
+// first goes through one batched circle/capsule test (BatchOverlapTest) against the
+// player, each grown to cover its whole motion around its midpoint; only those hits
+// get the exact swept test, which is then confirmed against the sprites' alpha masks
+// (checkPixelCollision). The earliest contact wins, and every creature's checkpoint
+// moves up to its current position.
+std::shared_ptr<GameEvent> DetectAquariumCollisions(std::shared_ptr<Aquarium> aquarium, std::shared_ptr<PlayerCreature> player, bool markCheckpoints) {
     if (!aquarium || !player) return nullptr;
-    
-    for (int i = 0; i < aquarium->getCreatureCount(); ++i) {
-        std::shared_ptr<Creature> npc = aquarium->getCreatureAt(i);
-        if (npc && checkCollision(player, npc)) {
-            return std::make_shared<GameEvent>(GameEventType::COLLISION, player, npc);
+
+    // per thread, so headless shards can detect in parallel
+    thread_local CollisionBatch batch;
+    thread_local std::vector<uint64_t> hits;
+
+    const std::vector<std::shared_ptr<Creature>>& creatures = aquarium->getCreatures();
+    batch.clear();
+    for (const std::shared_ptr<Creature>& npc : creatures) {
+        float mx = npc->getCenterX() - npc->getPrevCenterX(), my = npc->getCenterY() - npc->getPrevCenterY();
+        batch.add(npc->getPrevCenterX() + mx * 0.5f, npc->getPrevCenterY() + my * 0.5f,
+                  npc->getCollisionRadius() + std::sqrt(mx * mx + my * my) * 0.5f, npc->getCapsuleHalfLength());
+    }
+    float px = player->getCenterX() - player->getPrevCenterX(), py = player->getCenterY() - player->getPrevCenterY();
+    int candidates = BatchOverlapTest(player->getPrevCenterX() + px * 0.5f, player->getPrevCenterY() + py * 0.5f,
+                                      player->getCollisionRadius() + std::sqrt(px * px + py * py) * 0.5f, batch, hits);
+
+    const Creature* hit = nullptr;
+    size_t hitIndex = 0;
+    float earliest = 2.0f;
+    for (size_t word = 0; candidates > 0 && word < hits.size(); ++word) {
+        for (uint64_t bits = hits[word]; bits != 0; bits &= bits - 1) {
+            size_t i = word * 64 + LowestSetBit(bits);
+            const Creature& npc = *creatures[i];
+            float timeOfImpact;
+            // capsules sweep as their bounding circle; the pixel masks trim the ends
+            if (SweptCircleContact(player->getPrevCenterX(), player->getPrevCenterY(), player->getCenterX(), player->getCenterY(),
+                                   npc.getPrevCenterX(), npc.getPrevCenterY(), npc.getCenterX(), npc.getCenterY(),
+                                   player->getCollisionRadius() + npc.getCollisionRadius() + npc.getCapsuleHalfLength(), timeOfImpact)
+                && timeOfImpact < earliest
+                && checkPixelCollision(*player, npc, timeOfImpact)) { // circles are only the broad phase
+                earliest = timeOfImpact;
+                hit = &npc;
+                hitIndex = i;
+            }
+        }
+    }
+    if (markCheckpoints) {
+        for (const std::shared_ptr<Creature>& npc : creatures) {
+            npc->markCollisionCheckpoint();
         }
+        player->markCollisionCheckpoint();
+    }
+
+    if (hit) {
+        return makeEvent(GameEventType::COLLISION, player, creatures[hitIndex]);
     }
     return nullptr;
 };
 
-//  Imlementation of the AquariumScene
-void AquariumGameScene::Update() {
-    if (m_lastKnownLevel < 0 && m_aquarium) {
-        m_lastKnownLevel = m_aquarium->getCurrentLevel();
+// AquariumRules Implementation
+void AquariumRules::reset(const Aquarium& aquarium) {
+    m_cadence = AwaitFrames(5);
+    m_lastKnownLevel = aquarium.getCurrentLevel();
+}
+
+void AquariumRules::movePlayers(Aquarium& aquarium, float seconds, const std::shared_ptr<PlayerCreature>* players, size_t count) {
+    aquarium.advanceClock(seconds);
+    for (size_t i = 0; i < count; ++i) {
+        players[i]->update();
     }
+}
 
-    this->m_player->update();
+AquariumRules::Result AquariumRules::resolve(const std::shared_ptr<Aquarium>& aquarium, const std::shared_ptr<PlayerCreature>* players,
+                                             size_t count, const AquariumCollisionHandler& handler) {
+    Result result;
+    if (m_lastKnownLevel < 0) m_lastKnownLevel = aquarium->getCurrentLevel();
+    if (!m_cadence.tick()) return result;
+    result.checked = true;
+
+    {
+        FlightZoneTimer zone(aquarium->getFlightRecorder(), FlightZone::COLLISIONS);
+        bool markEach = count == 1; // with more players every check must see the same checkpoints
+        for (size_t i = 0; i < count; ++i) {
+            auto event = DetectAquariumCollisions(aquarium, players[i], markEach);
+            auto outcome = ResolveAquariumCollision(aquarium, players[i], event);
+            if (handler) handler(players[i], event, outcome);
+            if (outcome != nullptr && outcome->isGameOver() && !m_respawning) {
+                result.gameOver = true;
+                return result;
+            }
+        }
+        if (!markEach) {
+            for (const auto& creature : aquarium->getCreatures()) {
+                creature->markCollisionCheckpoint();
+            }
+            for (size_t i = 0; i < count; ++i) {
+                players[i]->markCollisionCheckpoint();
+            }
+        }
+    }
 
-    float deltaTime = ofGetLastFrameTime();
-    if (!m_activePowerUp) {
-        float x = ofRandom(100, ofGetWidth() - 100);
-        float y = ofRandom(100, ofGetHeight() - 100);
+    aquarium->update();
+    int currentLevel = aquarium->getCurrentLevel();
+    if (currentLevel != m_lastKnownLevel) {
+        auto spriteManager = aquarium->getSpriteManager();
+        std::shared_ptr<GameSprite> predatorSprite = spriteManager ? spriteManager->GetSprite(AquariumCreatureType::BiggerFish) : nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            players[i]->activatePredatorMode(10.0f, predatorSprite);
+        }
+        m_lastKnownLevel = currentLevel;
+        result.levelUp = true;
+    }
+    return result;
+}
 
-        m_activePowerUp = std::make_shared<PowerUp>(
-            x, y, PowerUpType::SPEED,
-            std::make_shared<GameSprite>("powerup.png", 40, 40)
-        );
+// Applies the outcome of a player/NPC collision (sting, damage or eating).
+// Shared by the game scene and the headless hosts so every caller plays by the same rules.
+// Returns GAME_OVER once the player runs out of lives, otherwise PLAYER_DAMAGED (only
+// when a life was actually lost) or CREATURE_REMOVED, or nullptr when nothing happened.
+std::shared_ptr<GameEvent> ResolveAquariumCollision(std::shared_ptr<Aquarium> aquarium, std::shared_ptr<PlayerCreature> player, std::shared_ptr<GameEvent> event) {
+    if (event == nullptr || !event->isCollisionEvent()) return nullptr;
+    ofLogVerbose() << "Collision detected between player and NPC!" << std::endl;
+    if (event->creatureB == nullptr) {
+        ofLogError() << "Error: creatureB is null in collision event." << std::endl;
+        return nullptr;
+    }
 
-        m_powerUpLifeTimer = m_powerUpLifetime;
-        ofLogNotice() << "Spawned a power-up!";
+    event->print();
+    auto npc = std::dynamic_pointer_cast<NPCreature>(event->creatureB);
+    if(npc && npc->GetType() == AquariumCreatureType::Jellyfish){
+        ofLogNotice() << "A jellyfish sting harms the player!";
+        bool damaged = player->loseLife(3*60);
+        if(player->getLives() <= 0){
+            return makeEvent(GameEventType::GAME_OVER, player, nullptr);
+        }
+        // still debounced: no sting sound and no flight event for every check while overlapping
+        return damaged ? makeEvent(GameEventType::PLAYER_DAMAGED, player, event->creatureB) : nullptr;
+    } else if(npc && npc->GetType() == AquariumCreatureType::Axolotl && player->isPredatorMode()){
+        ofLogNotice() << "Predator mode spares the axolotl.";
     } else {
-        m_powerUpLifeTimer -= deltaTime;
+        bool predatorActive = player->isPredatorMode();
+        bool isAxolotl = npc && npc->GetType() == AquariumCreatureType::Axolotl;
+        bool canEat = predatorActive || isAxolotl || player->getPower() >= event->creatureB->getValue();
+        if(!canEat){
+            ofLogNotice() << "Player is too weak to eat the creature!" << std::endl;
+            bool damaged = player->loseLife(3*60); // 3 seconds of clock ticks
+            if(player->getLives() <= 0){
+                return makeEvent(GameEventType::GAME_OVER, player, nullptr);
+            }
+            return damaged ? makeEvent(GameEventType::PLAYER_DAMAGED, player, event->creatureB) : nullptr;
+        }
+        else{
+            aquarium->removeCreature(event->creatureB);
+            player->addToScore(1, event->creatureB->getValue());
+            if (player->getScore() % 25 == 0){
+                player->increasePower(1);
+                ofLogNotice() << "Player power increased to " << player->getPower() << "!" << std::endl;
+            }
+            return makeEvent(GameEventType::CREATURE_REMOVED, player, event->creatureB);
+        }
+    }
+    return nullptr;
+}
 
-        bool collected = checkCollision(m_player, m_activePowerUp);
-        bool expired = m_powerUpLifeTimer <= 0.0f;
+bool IsDangerousToPlayer(const Creature& creature, const PlayerCreature& player) {
+    auto npc = dynamic_cast<const NPCreature*>(&creature);
+    AquariumCreatureType type = npc ? npc->GetType() : AquariumCreatureType::NPCreature;
+    if (type == AquariumCreatureType::Jellyfish) return true;
+    return type != AquariumCreatureType::Axolotl && !player.isPredatorMode() && player.getPower() < creature.getValue();
+}
 
-        if (collected) {
-            m_player->startBoost(m_activePowerUp->getType());
+bool IsEdibleByPlayer(const Creature& creature, const PlayerCreature& player) {
+    auto npc = dynamic_cast<const NPCreature*>(&creature);
+    AquariumCreatureType type = npc ? npc->GetType() : AquariumCreatureType::NPCreature;
+    if (type == AquariumCreatureType::Jellyfish) return false;
+    if (type == AquariumCreatureType::Axolotl) return !player.isPredatorMode(); // predators spare axolotls
+    return player.isPredatorMode() || player.getPower() >= creature.getValue();
+}
 
-            if (m_player->getSpeed() >= m_player->getBaseSpeed() * 1.5f) {
-                showBoostMessage("MAX SPEED BOOST");
-            } else {
-                showBoostMessage("SPEED BOOST!");
-            }
+// the level table used by the game; headless hosts build the same one per instance
+void AddDefaultAquariumLevels(std::shared_ptr<Aquarium> aquarium) {
+    MemoryScope memory(MemoryTag::LEVELS);
+    aquarium->addAquariumLevel(std::make_shared<Level_0>(0, 10));
+    aquarium->addAquariumLevel(std::make_shared<Level_1>(1, 30));
+    aquarium->addAquariumLevel(std::make_shared<Level_2>(2, 60));
+    aquarium->addAquariumLevel(std::make_shared<Level_3>(3, 120));
+    aquarium->addAquariumLevel(std::make_shared<Level_4>(4, 240));
+}
 
-            ofLogNotice() << "Player collected Speed Boost!";
-        } else if (expired) {
-            ofLogNotice() << "Power-up expired!";
-        }
+std::shared_ptr<GameScene> MakeHeadlessScene(const std::string& name, WorldCamera& camera, int viewWidth, int viewHeight) {
+    // the same view and world as ofApp, with the framebuffer as the window
+    camera.setViewSize(viewWidth, viewHeight);
+    camera.setWorldSize(6 * viewWidth, 3 * viewHeight);
+    camera.setViewport(viewWidth, viewHeight);
+    if (name == "intro") {
+        return std::make_shared<GameIntroScene>(GameSceneKindToString(GameSceneKind::GAME_INTRO),
+                                                std::make_shared<GameSprite>("title.png", viewWidth, viewHeight));
+    }
+    if (name == "game-over") {
+        return std::make_shared<GameOverScene>(GameSceneKindToString(GameSceneKind::GAME_OVER),
+                                               std::make_shared<GameSprite>("game-over.png", viewWidth, viewHeight));
+    }
+    if (name != "game") return nullptr;
+
+    int worldWidth = static_cast<int>(camera.getWorldWidth()), worldHeight = static_cast<int>(camera.getWorldHeight());
+    auto spriteManager = std::make_shared<AquariumSpriteManager>();
+    auto aquarium = std::make_shared<Aquarium>(worldWidth, worldHeight, spriteManager);
+    aquarium->setSeed(1); // the same population on every run, so frames can be compared
+    auto player = std::make_shared<PlayerCreature>(worldWidth / 2 - 50, worldHeight / 2 - 50, 5, spriteManager->GetSprite(AquariumCreatureType::NPCreature));
+    player->setDirection(0, 0);
+    player->setBounds(worldWidth - 20, worldHeight - 20);
+    camera.lookAt(player->getCenterX(), player->getCenterY());
+    aquarium->setActiveArea(camera.getViewX(), camera.getViewY(), camera.getViewWidth(), camera.getViewHeight());
+    AddDefaultAquariumLevels(aquarium);
+    aquarium->Repopulate();
+    // spawns keep off screen, so pose one of each NPC type around the player (two mirrored)
+    // to put every sprite on the frame; they sit outside the level count and only get drawn
+    float cx = player->getCenterX(), cy = player->getCenterY();
+    auto pose = [&](std::shared_ptr<NPCreature> npc, bool flipped) {
+        npc->setFlipped(flipped);
+        aquarium->addCreature(npc);
+    };
+    pose(std::make_shared<NPCreature>(cx - 320, cy - 220, 5, spriteManager->GetSprite(AquariumCreatureType::NPCreature)), false);
+    pose(std::make_shared<BiggerFish>(cx + 180, cy - 260, 5, spriteManager->GetSprite(AquariumCreatureType::BiggerFish)), true);
+    pose(std::make_shared<Axolotl>(cx - 280, cy + 160, 5, spriteManager->GetSprite(AquariumCreatureType::Axolotl)), true);
+    pose(std::make_shared<Jellyfish>(cx + 240, cy + 140, 5, spriteManager->GetSprite(AquariumCreatureType::Jellyfish)), false);
+
+    auto scene = std::make_shared<AquariumGameScene>(std::move(player), std::move(aquarium), GameSceneKindToString(GameSceneKind::AQUARIUM_GAME));
+    scene->SetCamera(&camera);
+    return scene;
+}
 
-        if (collected || expired) {
-            m_activePowerUp.reset();
-            m_powerUpLifeTimer = 0.0f;
-        }
+//  Imlementation of the AquariumScene
+void AquariumGameScene::Update() {
+    auto frameStart = std::chrono::steady_clock::now();
+    if (m_recorder && m_recorder->beginFrame(ofGetLastFrameTime())) {
+        this->recordFlightState();
+    }
+    FlightZoneTimer updateZone(m_recorder, FlightZone::UPDATE);
+    if (m_governor.evaluate()) {
+        this->applyGovernorLevel();
     }
 
-    if (m_boostMessageTimer > 0.0f) {
-        m_boostMessageTimer -= deltaTime;
-        if (m_boostMessageTimer <= 0.0f) {
-            m_boostMessage.clear();
+    {
+        FlightZoneTimer zone(m_recorder, FlightZone::PLAYER);
+        if (m_input) {
+            m_input->drain(); // the only place key state reaches the player
+            float dx = m_input->getDx();
+            m_player->setDirection(dx, m_input->getDy());
+            if (dx != 0.0f) m_player->setFlipped(dx < 0.0f);
+        }
+        // every timed effect in the scene and on the player fires from here
+        m_rules.movePlayers(*m_aquarium, ofGetLastFrameTime(), m_player);
+        if (m_camera) {
+            m_camera->lookAt(m_player->getCenterX(), m_player->getCenterY());
+            m_aquarium->setActiveArea(m_camera->getViewX(), m_camera->getViewY(), m_camera->getViewWidth(), m_camera->getViewHeight());
         }
     }
+    FlightZoneTimer powerUpZone(m_recorder, FlightZone::POWER_UPS);
+
+    if (!m_powerUpSpritesRequested) {
+        // one image for every type, told apart by tint
+        auto sprite = std::make_shared<GameSprite>("powerup.png", 40, 40);
+        m_powerUps.setSprite(PowerUpType::SPEED, sprite);
+        m_powerUps.setSprite(PowerUpType::SIZE, sprite, ofColor(120, 255, 140));
+        m_powerUpSpritesRequested = true;
+    }
+    ofRectangle view = this->getView(); // spawned where the player can see them
+    while (m_powerUps.getActiveCount() < m_powerUpTarget) {
+        float x = view.x + ofRandom(100, view.width - 100);
+        float y = view.y + ofRandom(100, view.height - 100);
+        PowerUpType type = static_cast<PowerUpType>(std::min(POWER_UP_TYPE_COUNT - 1, static_cast<int>(ofRandom(POWER_UP_TYPE_COUNT))));
+        if (!m_powerUps.spawn(x, y, type, m_powerUpLifetime)) break;
+        ofLogVerbose() << "Spawned a " << PowerUpTypeToString(type) << " power-up!";
+    }
 
-    if (this->updateControl.tick()) {
-        auto event = DetectAquariumCollisions(this->m_aquarium, this->m_player);
-        if (event != nullptr && event->isCollisionEvent()) {
-            ofLogVerbose() << "Collision detected between player and NPC!" << std::endl;
-            if(event->creatureB != nullptr){
-                event->print();
-                auto npc = std::dynamic_pointer_cast<NPCreature>(event->creatureB);
-                if(npc && npc->GetType() == AquariumCreatureType::Jellyfish){
-                    ofLogNotice() << "A jellyfish sting harms the player!";
-                    this->m_player->loseLife(3*60);
-                    if(this->m_player->getLives() <= 0){
-                        this->m_lastEvent = std::make_shared<GameEvent>(GameEventType::GAME_OVER, this->m_player, nullptr);
-                        return;
-                    }
-                } else if(npc && npc->GetType() == AquariumCreatureType::Axolotl && this->m_player->isPredatorMode()){
-                    ofLogNotice() << "Predator mode spares the axolotl.";
-                } else {
-                    bool predatorActive = this->m_player->isPredatorMode();
-                    bool isAxolotl = npc && npc->GetType() == AquariumCreatureType::Axolotl;
-                    bool canEat = predatorActive || isAxolotl || this->m_player->getPower() >= event->creatureB->getValue();
-                    if(!canEat){
-                        ofLogNotice() << "Player is too weak to eat the creature!" << std::endl;
-                        this->m_player->loseLife(3*60); // 3 frames debounce, 3 seconds at 60fps
-                        if(this->m_player->getLives() <= 0){
-                            this->m_lastEvent = std::make_shared<GameEvent>(GameEventType::GAME_OVER, this->m_player, nullptr);
-                            return;
-                        }
-                    }
-                    else{
-                        this->m_aquarium->removeCreature(event->creatureB);
-                        this->m_player->addToScore(1, event->creatureB->getValue());
-                        if (this->m_player->getScore() % 25 == 0){
-                            this->m_player->increasePower(1);
-                            ofLogNotice() << "Player power increased to " << this->m_player->getPower() << "!" << std::endl;
-                        }
-                        
-                    }
-                }
-                
-                
+    for (PowerUpType type : m_powerUps.collect(*m_player)) {
+        m_player->startBoost(type);
+        if (m_audio) m_audio->playEffect(SoundEffect::POWER_UP);
+        if (m_recorder) m_recorder->addEvent(FlightEvent::POWER_UP);
 
-            } else {
-                ofLogError() << "Error: creatureB is null in collision event." << std::endl;
-            }
+        if (type == PowerUpType::SIZE) {
+            showBoostMessage("SIZE BOOST!");
+        } else if (m_player->getSpeed() >= m_player->getBaseSpeed() * 1.5f) {
+            showBoostMessage("MAX SPEED BOOST");
+        } else {
+            showBoostMessage("SPEED BOOST!");
         }
 
-        this->m_aquarium->update();
-
-        int currentLevel = this->m_aquarium->getCurrentLevel();
-        if (currentLevel != m_lastKnownLevel) {
-            auto spriteManager = this->m_aquarium->getSpriteManager();
-            std::shared_ptr<GameSprite> predatorSprite = spriteManager ? spriteManager->GetSprite(AquariumCreatureType::BiggerFish) : nullptr;
-            this->m_player->activatePredatorMode(10.0f, predatorSprite);
-            showBoostMessage("PREDATOR MODE!");
-            m_lastKnownLevel = currentLevel;
+        ofLogNotice() << "Player collected " << PowerUpTypeToString(type) << " Boost!";
+    }
+    powerUpZone.stop();
+
+    auto tickStart = std::chrono::steady_clock::now();
+    AquariumRules::Result tick = m_rules.resolve(m_aquarium, m_player, [this](const std::shared_ptr<PlayerCreature>&,
+            const std::shared_ptr<GameEvent>& event, const std::shared_ptr<GameEvent>& outcome) {
+        if (m_recorder) this->recordFlightEvents(event, outcome);
+        if (outcome == nullptr) return;
+        if (outcome->isGameOver()) {
+            this->m_lastEvent = outcome;
+        } else if (m_audio) {
+            if (outcome->isCreatureRemovedEvent()) m_audio->playEffect(SoundEffect::EAT);
+            if (outcome->isPlayerDamagedEvent()) m_audio->playEffect(SoundEffect::STING);
         }
+    });
+    if (tick.levelUp) {
+        showBoostMessage("PREDATOR MODE!");
+        if (m_audio) m_audio->playEffect(SoundEffect::LEVEL_UP);
+        if (m_recorder) m_recorder->addEvent(FlightEvent::LEVEL_UP);
+        this->applyGovernorLevel(); // the cap is a share of the new level's population
+    }
+    if (tick.checked && !tick.gameOver) {
+        m_governor.sampleTick(std::chrono::duration<float>(std::chrono::steady_clock::now() - tickStart).count());
     }
+    m_frameWorkSeconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - frameStart).count();
+}
+
+void AquariumGameScene::SetFlightRecorder(FlightRecorder* recorder) {
+    m_recorder = recorder;
+    m_aquarium->setFlightRecorder(recorder);
+}
+
+// as the frame found it, so a frame that never finishes still says where it started
+void AquariumGameScene::recordFlightState() {
+    FlightRecord* record = m_recorder->getCurrent();
+    record->creatures = static_cast<uint16_t>(std::min(m_aquarium->getCreatureCount(), 65535));
+    record->dormant = static_cast<uint16_t>(std::min<size_t>(m_aquarium->getChunks().getDormantCount(), 65535));
+    record->score = m_player->getScore();
+    record->playerX = static_cast<int16_t>(std::clamp(m_player->getCenterX(), -32768.0f, 32767.0f));
+    record->playerY = static_cast<int16_t>(std::clamp(m_player->getCenterY(), -32768.0f, 32767.0f));
+    record->level = static_cast<uint8_t>(std::max(0, m_aquarium->getCurrentLevel()));
+    record->lives = static_cast<uint8_t>(std::clamp(m_player->getLives(), 0, 255));
+    record->power = static_cast<uint8_t>(std::clamp(m_player->getPower(), 0, 255));
+    record->quality = static_cast<uint8_t>(m_governor.getLevel());
+    if (m_player->isPredatorMode()) record->playerFlags |= FLIGHT_PREDATOR;
+    if (m_player->isDamageDebounced()) record->playerFlags |= FLIGHT_DAMAGED;
+    if (m_player->hasBoost(PowerUpType::SPEED)) record->playerFlags |= FLIGHT_SPEED_BOOST;
+    if (m_player->hasBoost(PowerUpType::SIZE)) record->playerFlags |= FLIGHT_SIZE_BOOST;
+}
+
+void AquariumGameScene::recordFlightEvents(const std::shared_ptr<GameEvent>& event, const std::shared_ptr<GameEvent>& outcome) {
+    if (event != nullptr && event->isCollisionEvent()) m_recorder->addEvent(FlightEvent::COLLISION);
+    if (outcome == nullptr) return;
+    if (outcome->isCreatureRemovedEvent()) m_recorder->addEvent(FlightEvent::EATEN);
+    if (outcome->isPlayerDamagedEvent()) m_recorder->addEvent(FlightEvent::DAMAGED);
+    if (outcome->isGameOver()) m_recorder->addEvent(FlightEvent::GAME_OVER);
+}
+
+void AquariumGameScene::Restart() {
+    auto spriteManager = m_aquarium->getSpriteManager();
+    int width = m_aquarium->getWidth(), height = m_aquarium->getHeight();
+    m_player = std::make_shared<PlayerCreature>(width / 2 - 50, height / 2 - 50, static_cast<int>(m_player->getBaseSpeed()),
+        spriteManager ? spriteManager->GetSprite(AquariumCreatureType::NPCreature) : nullptr);
+    m_player->setDirection(0, 0);
+    m_player->setBounds(width - 20, height - 20);
+    m_aquarium->setPlayer(m_player);
+    m_aquarium->reset();
+    m_lastEvent = nullptr;
+    m_rules.reset(*m_aquarium);
+    m_hudScore = m_hudPower = m_hudLives = -1;
+    this->applyGovernorLevel();
+}
+
+void AquariumGameScene::applyGovernorLevel() {
+    const GovernorLevel& quality = m_governor.getSettings();
+    int levelPopulation = m_aquarium->getLevelPopulation();
+    int cap = quality.populationScale >= 1.0f ? 0 : std::max(1, static_cast<int>(std::ceil(levelPopulation * quality.populationScale)));
+    m_aquarium->setMaxPopulation(cap);
+
+    SchoolingSettings school = m_aquarium->getSchooling(AquariumCreatureType::NPCreature);
+    school.enabled = quality.schoolingNeighbors > 0;
+    school.maxNeighbors = std::max(1, quality.schoolingNeighbors);
+    m_aquarium->setSchooling(AquariumCreatureType::NPCreature, school);
+
+    SimulationLod lod = m_aquarium->getSimulationLod();
+    lod.farInterval = quality.lodInterval;
+    m_aquarium->setSimulationLod(lod);
 }
 
 void AquariumGameScene::showBoostMessage(const std::string& msg) {
     m_boostMessage = msg;
-    m_boostMessageTimer = 4.0f; // show message for longer visibility
+    auto timers = m_aquarium->getTimers();
+    timers->cancel(m_boostMessageExpiry);
+    m_boostMessageExpiry = timers->schedule(4.0f, [this]() { // show message for longer visibility
+        m_boostMessageExpiry = TimerId();
+        m_boostMessage.clear();
+    });
+}
+
+ofRectangle AquariumGameScene::getView() const {
+    if (m_camera) return ofRectangle(m_camera->getViewX(), m_camera->getViewY(), m_camera->getViewWidth(), m_camera->getViewHeight());
+    return ofRectangle(0, 0, m_aquarium->getWidth(), m_aquarium->getHeight());
+}
+
+AquariumGameScene::~AquariumGameScene() {
+    m_aquarium->getTimers()->cancel(m_boostMessageExpiry);
 }
 
 void AquariumGameScene::Draw() {
+    auto drawStart = std::chrono::steady_clock::now();
+    FlightZoneTimer drawZone(m_recorder, FlightZone::DRAW);
+    if (m_camera) m_camera->beginWorld();
     this->m_player->draw();
     this->m_aquarium->draw();
     
-    if (m_activePowerUp) {
-    m_activePowerUp->draw();
-}
-    this->paintAquariumHUD();
-    
-  // Draw the boost message if active
-if (!m_boostMessage.empty()) {
-    ofSetColor(ofColor::yellow);
-    ofDrawBitmapString(m_boostMessage, ofGetWidth() / 2 - 50, 100); // adjust position
-    ofSetColor(ofColor::white); // reset color
-    
-}
+    m_powerUps.draw();
+    if (m_camera) m_camera->endWorld();
+    this->paintAquariumHUD(); // includes the boost message, pinned to the view
+    double inputLatency = m_input ? m_input->markDisplayed() : -1.0;
+    if (inputLatency >= 0.0 && m_recorder && m_recorder->getCurrent()) {
+        m_recorder->getCurrent()->inputMillis = static_cast<uint8_t>(std::min(inputLatency * 1000.0, 255.0));
+    }
+    m_governor.sampleFrame(m_frameWorkSeconds + std::chrono::duration<float>(std::chrono::steady_clock::now() - drawStart).count());
 }
 
 
 void AquariumGameScene::paintAquariumHUD(){
-    float panelWidth = ofGetWindowWidth() - 150;
-    ofDrawBitmapString("Score: " + std::to_string(this->m_player->getScore()), panelWidth, 20);
-    ofDrawBitmapString("Power: " + std::to_string(this->m_player->getPower()), panelWidth, 30);
-    ofDrawBitmapString("Lives: " + std::to_string(this->m_player->getLives()), panelWidth, 40);
-    for (int i = 0; i < this->m_player->getLives(); ++i) {
-        ofSetColor(ofColor::red);
-        ofDrawCircle(panelWidth + i * 20, 50, 5);
+    if (!m_hudFontRequested && GetSoftwareRenderTarget() == nullptr) { // software frames use bitmap text and may have no GL context
+        m_hud.load("Monaco.ttf", 8);
+        m_hudFontRequested = true;
+    }
+
+    float viewWidth = this->getView().width;
+    float panelWidth = viewWidth - 150; // view units, the camera scales the HUD with the window
+    if (panelWidth != m_hudPanelWidth) { // window resized, lay everything out again
+        m_hudPanelWidth = panelWidth;
+        m_hudScore = m_hudPower = m_hudLives = m_hudQuality = -1;
+    }
+    if (this->m_player->getScore() != m_hudScore) {
+        m_hudScore = this->m_player->getScore();
+        m_hud.setLine(0, "Score: " + std::to_string(m_hudScore), panelWidth, 20, ofColor::white);
+    }
+    if (this->m_player->getPower() != m_hudPower) {
+        m_hudPower = this->m_player->getPower();
+        m_hud.setLine(1, "Power: " + std::to_string(m_hudPower), panelWidth, 30, ofColor::white);
+    }
+    if (this->m_player->getLives() != m_hudLives) {
+        m_hudLives = this->m_player->getLives();
+        m_hud.setLine(2, "Lives: " + std::to_string(m_hudLives), panelWidth, 40, ofColor::white);
+        m_hud.setMarkers(m_hudLives, panelWidth, 50, 20, 5, ofColor::red);
+    }
+    m_hud.setLine(3, m_boostMessage, viewWidth / 2 - 50, 100, ofColor::yellow);
+    if (m_governor.getLevel() != m_hudQuality) {
+        m_hudQuality = m_governor.getLevel();
+        m_hud.setLine(4, m_governor.describe(), panelWidth, 85, m_hudQuality == 0 ? ofColor::white : ofColor::orange);
+    }
+    if (m_showMemory && m_memoryRefresh-- <= 0) {
+        m_memoryRefresh = 30; // these change every frame, so twice a second is plenty
+        for (int i = 0; i < MEMORY_TAG_COUNT; ++i) {
+            m_hud.setLine(5 + i, DescribeMemoryTag(static_cast<MemoryTag>(i)), 10, 20 + 10 * i, ofColor(140, 255, 140));
+        }
+        m_hud.setLine(5 + MEMORY_TAG_COUNT, "rss: " + std::to_string(GetResidentBytes() / 1024) + "KB", 10, 20 + 10 * MEMORY_TAG_COUNT, ofColor(140, 255, 140));
+    }
+    m_hud.draw();
+}
+
+void AquariumGameScene::ToggleMemoryHud() {
+    m_showMemory = !m_showMemory;
+    m_memoryRefresh = 0;
+    if (!m_showMemory) {
+        for (int i = 0; i <= MEMORY_TAG_COUNT; ++i) m_hud.setLine(5 + i, "", 0, 0, ofColor::white);
     }
-    ofSetColor(ofColor::white); // Reset color to white for other drawings
 }
 
 void AquariumLevel::populationReset(){
@@ -643,11 +1179,49 @@ void AquariumLevel::ConsumePopulation(AquariumCreatureType creatureType, int pow
     }
 }
 
+void AquariumLevel::ReleasePopulation(AquariumCreatureType creatureType){
+    for(std::shared_ptr<AquariumLevelPopulationNode> node: this->m_levelPopulation){
+        if(node->creatureType == creatureType){
+            node->currentPopulation = std::max(0, node->currentPopulation - 1);
+            return;
+        }
+    }
+}
+
+bool AquariumLevel::ClaimPopulation(AquariumCreatureType creatureType){
+    for(std::shared_ptr<AquariumLevelPopulationNode> node: this->m_levelPopulation){
+        if(node->creatureType == creatureType){
+            if(node->currentPopulation >= node->population){
+                return false;
+            }
+            node->currentPopulation += 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+int AquariumLevel::getTotalPopulation() const{
+    int total = 0;
+    for(const auto& node: this->m_levelPopulation){
+        total += std::max(0, node->population);
+    }
+    return total;
+}
+
+int AquariumLevel::getPopulation(AquariumCreatureType creatureType) const{
+    for(const auto& node: this->m_levelPopulation){
+        if(node->creatureType == creatureType) return std::max(0, node->population);
+    }
+    return 0;
+}
+
 bool AquariumLevel::isCompleted(){
     return this->m_level_score >= this->m_targetScore;
 }
 
 std::vector<AquariumCreatureType> AquariumLevel::Repopulate() {
+    MemoryScope memory(MemoryTag::LEVELS);
     std::vector<AquariumCreatureType> toRepopulate;
     for (const auto& node : m_levelPopulation) {
         if (!node) {
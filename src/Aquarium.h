@@ -4,18 +4,24 @@
 #include <memory>
 #include <iostream>
 #include <algorithm>
+#include <random>
+#include <functional>
 #include "Core.h"
+#include "CreatureBehavior.h"
+#include "CreaturePool.h"
+#include "AudioSystem.h"
+#include "HudText.h"
+#include "Schooling.h"
+#include "PerformanceGovernor.h"
+#include "TimerWheel.h"
 #include "PowerUp.h"
+#include "WorldChunks.h"
+#include "WorldCamera.h"
+#include "FlightRecorder.h"
+#include "InputQueue.h"
 
 
 
-enum class AquariumCreatureType {
-    NPCreature,
-    BiggerFish,
-    Axolotl,
-    Jellyfish
-};
-
 string AquariumCreatureTypeToString(AquariumCreatureType t);
 
 class AquariumLevelPopulationNode {
@@ -50,6 +56,10 @@ public:
     }
 
     void ConsumePopulation(AquariumCreatureType creature, int power);
+    void ReleasePopulation(AquariumCreatureType creature); // give a slot back without scoring it
+    bool ClaimPopulation(AquariumCreatureType creature);   // a paged-in creature takes a free slot, false when full
+    int getTotalPopulation() const;
+    int getPopulation(AquariumCreatureType creature) const; // the level's target for one type
     bool isCompleted() override;
     void populationReset();
     void levelReset() { m_level_score = 0; populationReset(); }
@@ -66,31 +76,30 @@ protected:
     public:
 
         PlayerCreature(float x, float y, int speed, std::shared_ptr<GameSprite> sprite);
+        ~PlayerCreature();
     void move();
     void draw() const;
     void update();
     void changeSpeed(int speed);
     void setLives(int lives) { m_lives = lives; }
-    void setDirection(float dx, float dy);
     float isXDirectionActive() { return m_dx != 0; }
     float isYDirectionActive() {return m_dy != 0; }
-    float getDx() { return m_dx; }
-    float getDy() { return m_dy; }
 
     int getScore()const { return m_score; }
     int getLives() const { return m_lives; }
     int getPower() const { return m_power; }
     
     void addToScore(int amount, int weight=1) { m_score += amount * weight; }
-    void loseLife(int debounce);
+    bool loseLife(int debounceTicks); // false while the last hit is still debounced
     void increasePower(int value) { m_power += value; }
-    void reduceDamageDebounce();
+    bool isDamageDebounced() const { return m_timers && m_timers->isPending(m_damageDebounceTimer); }
+
+    // timed effects run on the simulation clock; Aquarium::setPlayer attaches it
+    void setTimers(std::shared_ptr<TimerWheel> timers);
     
     void startBoost(float seconds, PowerUpType type); // main implementation
     void startBoost(PowerUpType type);                // convenience overload
-
-    void updateBoost(float deltaTime);
-    void updatePredator(float deltaTime);
+    bool hasBoost(PowerUpType type) const { return m_timers && m_timers->isPending(m_boostTimers[static_cast<int>(type)]); }
 
     void activatePredatorMode(float seconds, std::shared_ptr<GameSprite> predatorSprite);
     void deactivatePredatorMode();
@@ -101,13 +110,12 @@ protected:
     float getBaseCollisionRadius() const { return m_baseRadius; }
     
 private:
+    void endBoost(PowerUpType type);
   
-    std::shared_ptr<PowerUp> m_activePowerUp = nullptr;
-    
-bool m_boosted = false;
-bool m_hasActiveBoost = false;
-PowerUpType m_currentBoostType{PowerUpType::SPEED};
-float m_boostTimer = 0.0f;
+std::shared_ptr<TimerWheel> m_timers;
+std::array<TimerId, POWER_UP_TYPE_COUNT> m_boostTimers; // one per type, so boosts stack
+TimerId m_predatorTimer;
+TimerId m_damageDebounceTimer;
 float m_sizeBoostMultiplier = 1.0f;
 float m_baseSpeed;
 float m_speed;
@@ -115,8 +123,6 @@ float m_originalSpeed;
 float m_baseRadius;
 float m_predatorCollisionRadius = 60.0f;
 bool m_inPredatorMode = false;
-float m_predatorTimer = 0.0f;
-float m_predatorEndTime = 0.0f;
 std::shared_ptr<GameSprite> m_normalSprite;
 std::shared_ptr<GameSprite> m_predatorSprite;
 
@@ -125,13 +131,12 @@ std::shared_ptr<GameSprite> m_predatorSprite;
     int m_score = 0;
     int m_lives = 3;
     int m_power = 1; // mark current power lvl
-    int m_damage_debounce = 0; // frames to wait after eating
 };
 
 class NPCreature : public Creature {
 public:
     NPCreature(float x, float y, int speed, std::shared_ptr<GameSprite> sprite);
-    AquariumCreatureType GetType() {return this->m_creatureType;}
+    AquariumCreatureType GetType() const {return this->m_creatureType;}
     void move() override;
     void draw() const override;
 protected:
@@ -146,12 +151,29 @@ public:
     void draw() const override;
 };
 
+class Axolotl : public NPCreature {
+public:
+    Axolotl(float x, float y, int speed, std::shared_ptr<GameSprite> sprite);
+    void move() override;
+    void draw() const override;
+};
+
+class Jellyfish : public NPCreature {
+public:
+    Jellyfish(float x, float y, int speed, std::shared_ptr<GameSprite> sprite);
+    void move() override;
+    void draw() const override;
+};
+
 
 class AquariumSpriteManager {
     public:
-        AquariumSpriteManager();
+        explicit AquariumSpriteManager(bool loadImages = true);
         ~AquariumSpriteManager() = default;
         std::shared_ptr<GameSprite>GetSprite(AquariumCreatureType t);
+        // drawn size of each type's sprite, also used for hitboxes when headless
+        static std::pair<int, int> GetSpriteSize(AquariumCreatureType t);
+        bool isHeadless() const { return m_npc_fish == nullptr; }
     private:
         std::shared_ptr<GameSprite> m_npc_fish;
         std::shared_ptr<GameSprite> m_big_fish;
@@ -167,68 +189,201 @@ public:
     void addAquariumLevel(std::shared_ptr<AquariumLevel> level);
     void removeCreature(std::shared_ptr<Creature> creature);
     void clearCreatures();
+    void reset();
     void update();
+    void updateFlowField();
+    void moveCreatures();
     void draw() const;
-    void setBounds(int w, int h) { m_width = w; m_height = h; }
-    void setMaxPopulation(int n) { m_maxPopulation = n; }
+    void setBounds(int w, int h);
+    // the part of the world on screen; only the chunks around it stay live (see WorldChunks)
+    void setActiveArea(float x, float y, float width, float height);
+    const WorldChunks& getChunks() const { return m_chunks; }
+    void setPlayer(std::shared_ptr<PlayerCreature> player); // steering target, joins the clock
+    // more players share the tank on a server; NPCs chase or flee the nearest one
+    void addPlayer(std::shared_ptr<PlayerCreature> player);
+    void removePlayer(std::shared_ptr<PlayerCreature> player);
+    bool hasPlayer() const;
+    void advanceClock(float seconds) { m_timers->advance(seconds); } // once per frame
+    std::shared_ptr<TimerWheel> getTimers() const { return m_timers; }
+    void setSchooling(AquariumCreatureType type, const SchoolingSettings& settings) { m_schoolingSettings[static_cast<int>(type)] = settings; }
+    const SchoolingSettings& getSchooling(AquariumCreatureType type) const { return m_schoolingSettings[static_cast<int>(type)]; }
+    void setThreadPool(ThreadPool* pool) { m_pool = pool; } // optional, for large schools
+    void setFlightRecorder(FlightRecorder* recorder) { m_recorder = recorder; } // optional, times update()'s zones
+    FlightRecorder* getFlightRecorder() const { return m_recorder; }
+    void setSimulationLod(const SimulationLod& lod) { m_lod = lod; }
+    const SimulationLod& getSimulationLod() const { return m_lod; }
+    int getActiveCreatureCount() const { return m_activeCreatures; } // moved on the last tick
+    void setMaxPopulation(int n) { m_maxPopulation = n; } // 0 means the level decides
+    int getMaxPopulation() const { return m_maxPopulation; }
+    int getLevelPopulation() const; // what the current level wants in the tank
     void Repopulate();
     void SpawnCreature(AquariumCreatureType type);
+    void setSeed(unsigned int seed) { m_rng.seed(seed); }
     
     std::shared_ptr<Creature> getCreatureAt(int index);
+    const std::vector<std::shared_ptr<Creature>>& getCreatures() const { return m_creatures; }
     int getCreatureCount() const { return m_creatures.size(); }
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
     int getCurrentLevel() const;
+    const FlowField& getFlowField() const { return m_flowField; }
     std::shared_ptr<AquariumSpriteManager> getSpriteManager() const { return m_sprite_manager; }
 
 
 private:
+    std::vector<std::shared_ptr<Creature>>::iterator detachCreature(std::vector<std::shared_ptr<Creature>>::iterator it);
+    void cullToMaxPopulation();
+    void streamChunks();
+    std::shared_ptr<NPCreature> createCreature(AquariumCreatureType type, float x, float y, int speed);
+
     int m_maxPopulation = 0;
     int m_width;
     int m_height;
     int currentLevel = 0;
     std::vector<std::shared_ptr<Creature>> m_creatures;
     std::vector<std::shared_ptr<Creature>> m_next_creatures;
+    CreatureBuckets m_creatureBuckets; // non-owning, one per NPC type, for moveCreatures
+    std::array<std::shared_ptr<CreaturePool>, AQUARIUM_CREATURE_TYPE_COUNT> m_creaturePools; // keeps each bucket dense
+    CreatureBuckets m_dueBuckets; // the part of each bucket that moves this tick
+    SimulationLod m_lod;
+    unsigned long m_simTick = 0;
+    int m_activeCreatures = 0;
+    std::vector<Creature*> m_otherCreatures; // anything without a static behavior
+    std::vector<std::weak_ptr<PlayerCreature>> m_players;
+    std::vector<glm::vec2> m_playerCenters; // flow field sources, rebuilt every tick
+    uint32_t m_nextCreatureId = 0;
+    FlowField m_flowField;
+    std::array<SchoolingSettings, AQUARIUM_CREATURE_TYPE_COUNT> m_schoolingSettings;
+    std::array<SchoolingSystem, AQUARIUM_CREATURE_TYPE_COUNT> m_schooling;
+    ThreadPool* m_pool = nullptr;
+    FlightRecorder* m_recorder = nullptr;
     std::vector<std::shared_ptr<AquariumLevel>> m_aquariumlevels;
     std::shared_ptr<AquariumSpriteManager> m_sprite_manager;
+    std::mt19937 m_rng;
+    WorldChunks m_chunks;
+    bool m_chunksChanged = false;
+    bool m_wakePending = false; // the active chunks moved or a level slot was freed since the last wake
+    std::vector<DormantCreature> m_wokenCreatures; // scratch for streamChunks
+    float m_viewX = 0.0f, m_viewY = 0.0f, m_viewWidth = 0.0f, m_viewHeight = 0.0f; // 0 wide: no view, draw everything
+    std::shared_ptr<TimerWheel> m_timers = std::make_shared<TimerWheel>(); // the simulation clock
 };
 
 
-std::shared_ptr<GameEvent> DetectAquariumCollisions(std::shared_ptr<Aquarium> aquarium, std::shared_ptr<PlayerCreature> player);
+// with several players, pass markCheckpoints=false for each and mark them all once afterwards
+std::shared_ptr<GameEvent> DetectAquariumCollisions(std::shared_ptr<Aquarium> aquarium, std::shared_ptr<PlayerCreature> player, bool markCheckpoints = true);
+std::shared_ptr<GameEvent> ResolveAquariumCollision(std::shared_ptr<Aquarium> aquarium, std::shared_ptr<PlayerCreature> player, std::shared_ptr<GameEvent> event);
+// what touching `creature` would do to `player`, by the rules ResolveAquariumCollision applies
+bool IsDangerousToPlayer(const Creature& creature, const PlayerCreature& player);
+bool IsEdibleByPlayer(const Creature& creature, const PlayerCreature& player);
+
+// what one player's collision check found and what resolving it did; either may be null
+using AquariumCollisionHandler = std::function<void(const std::shared_ptr<PlayerCreature>& player,
+    const std::shared_ptr<GameEvent>& event, const std::shared_ptr<GameEvent>& outcome)>;
+
+// The tick every simulation of the tank runs, whether the game scene, a headless shard
+// or the server drives it: the clock advances and the players move every tick; every
+// sixth tick each player's collisions are resolved, the tank updates, and a new level
+// puts every player in predator mode. Callers add their own effects around the two
+// halves (sounds, HUD messages, counters, respawns).
+class AquariumRules {
+public:
+    struct Result {
+        bool checked = false;  // collisions ran this tick
+        bool gameOver = false; // a player's run ended; the tank was not updated
+        bool levelUp = false;
+    };
+
+    // with respawning, a game over is the handler's to deal with (the server respawns the
+    // player there) and the tick carries on; otherwise it ends the tick
+    explicit AquariumRules(bool respawning = false) : m_respawning(respawning) {}
+
+    void reset(const Aquarium& aquarium); // restarts the cadence at the tank's current level
+    void movePlayers(Aquarium& aquarium, float seconds, const std::shared_ptr<PlayerCreature>* players, size_t count);
+    Result resolve(const std::shared_ptr<Aquarium>& aquarium, const std::shared_ptr<PlayerCreature>* players, size_t count,
+                   const AquariumCollisionHandler& handler = nullptr);
+
+    void movePlayers(Aquarium& aquarium, float seconds, const std::shared_ptr<PlayerCreature>& player) {
+        movePlayers(aquarium, seconds, &player, 1);
+    }
+    Result resolve(const std::shared_ptr<Aquarium>& aquarium, const std::shared_ptr<PlayerCreature>& player,
+                   const AquariumCollisionHandler& handler = nullptr) {
+        return resolve(aquarium, &player, 1, handler);
+    }
+
+private:
+    AwaitFrames m_cadence{5};
+    int m_lastKnownLevel = -1; // -1 until the first resolve
+    bool m_respawning;
+};
 
 
 class AquariumGameScene : public GameScene {
     public:
         AquariumGameScene(std::shared_ptr<PlayerCreature> player, std::shared_ptr<Aquarium> aquarium, string name)
-        : m_player(std::move(player)) , m_aquarium(std::move(aquarium)), m_name(name){}
+        : m_player(std::move(player)) , m_aquarium(std::move(aquarium)), m_name(name){
+            m_aquarium->setPlayer(m_player);
+            m_powerUps.setTimers(m_aquarium->getTimers());
+            m_powerUps.resize(m_aquarium->getWidth(), m_aquarium->getHeight());
+        }
+        ~AquariumGameScene();
         std::shared_ptr<GameEvent> GetLastEvent(){return m_lastEvent;}
         void SetLastEvent(std::shared_ptr<GameEvent> event){this->m_lastEvent = event;}
         std::shared_ptr<PlayerCreature> GetPlayer(){return this->m_player;}
+        void Restart(); // fresh player and first level, for runs that outlive a game over
         std::shared_ptr<Aquarium> GetAquarium(){return this->m_aquarium;}
+        void SetAudioSystem(std::shared_ptr<AudioSystem> audio){this->m_audio = std::move(audio);}
+        void SetCamera(WorldCamera* camera){this->m_camera = camera;} // follows the player; without one the tank is drawn unscrolled
+        void SetFlightRecorder(FlightRecorder* recorder); // one record per frame, owned by the app
+        void SetInput(InputQueue* input){this->m_input = input;} // steers the player from held keys; owned by the app
         string GetName()override {return this->m_name;}
         void Update() override;
         void Draw() override;
 
         void showBoostMessage(const std::string& msg);
+        PowerUpField& GetPowerUps(){return this->m_powerUps;}
+        void SetPowerUpTarget(int count){this->m_powerUpTarget = count;} // how many float in the tank at once
+        PerformanceGovernor& GetGovernor(){return this->m_governor;}
+        void ToggleMemoryHud(); // heap and texture bytes per MemoryTag
 
     private:
         void paintAquariumHUD();
+        void applyGovernorLevel();
+        void recordFlightState();
+        void recordFlightEvents(const std::shared_ptr<GameEvent>& event, const std::shared_ptr<GameEvent>& outcome);
+        ofRectangle getView() const; // camera view in world units, or the whole tank without a camera
         std::shared_ptr<PlayerCreature> m_player;
         std::shared_ptr<Aquarium> m_aquarium;
         std::shared_ptr<GameEvent> m_lastEvent;
+        std::shared_ptr<AudioSystem> m_audio; // optional, events stay silent without it
+        WorldCamera* m_camera = nullptr; // owned by the app
+        FlightRecorder* m_recorder = nullptr; // owned by the app
+        InputQueue* m_input = nullptr; // owned by the app
         string m_name;
-        AwaitFrames updateControl{5};
+        AquariumRules m_rules;
 
-    std::shared_ptr<PowerUp> m_activePowerUp;
-    float m_powerUpLifeTimer = 0.0f;     // Lifetime countdown
+    PowerUpField m_powerUps;
+    bool m_powerUpSpritesRequested = false;
+    int m_powerUpTarget = 1;
     float m_powerUpLifetime = 6.0f;      // Power-up disappears after 6 seconds
 
 
     std::string m_boostMessage;
-    float m_boostMessageTimer = 0.0f; // how long to show the message in seconds
-    ofTrueTypeFont m_messageFont;     // font for messages
-    int m_lastKnownLevel = -1;
-
+    TimerId m_boostMessageExpiry; // clears the message
+
+    // retained HUD; strings are only rebuilt when the value behind them changes
+    HudTextLayer m_hud;
+    bool m_hudFontRequested = false;
+    float m_hudPanelWidth = -1.0f;
+    int m_hudScore = -1;
+    int m_hudPower = -1;
+    int m_hudLives = -1;
+    int m_hudQuality = -1;
+    bool m_showMemory = false;
+    int m_memoryRefresh = 0; // frames until the memory lines are rebuilt
+
+    // scales population, schooling and background drawing to the frame budget
+    PerformanceGovernor m_governor;
+    float m_frameWorkSeconds = 0.0f; // this frame's Update time, Draw adds to it
 
 };
 
@@ -285,3 +440,12 @@ class Level_4 : public AquariumLevel  {
         bool isCompleted() override;
 
 };
+
+void AddDefaultAquariumLevels(std::shared_ptr<Aquarium> aquarium);
+
+// Builds scene `name` ("intro", "game" or "game-over") as ofApp::setup does and points
+// `camera` at it, for software frames without a window; call
+// GameSprite::setUseTextures(false) first. The game is seeded and poses one of each NPC
+// type in view, so its frames repeat and cover every sprite.
+// nullptr for an unknown name.
+std::shared_ptr<GameScene> MakeHeadlessScene(const std::string& name, WorldCamera& camera, int viewWidth = 1024, int viewHeight = 768);
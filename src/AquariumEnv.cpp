@@ -0,0 +1,167 @@
+#include "AquariumEnv.h"
+#include <chrono>
+#include <cmath>
+#include <random>
+
+
+// action -> heading; diagonals are normalized by setDirection
+static const int ACTION_DIRECTIONS[AquariumEnv::ACTION_COUNT][2] = {
+    {0, 0}, {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
+};
+
+AquariumEnv::AquariumEnv(int count, const AquariumEnvConfig& config)
+    : m_config(config)
+    , m_spriteManager(std::make_shared<AquariumSpriteManager>(false))
+    , m_pool(config.workers) {
+    count = std::max(1, count);
+    for (int i = 0; i < count; ++i) {
+        m_shards.push_back(std::make_shared<AquariumShard>(m_config.width, m_config.height, i, m_spriteManager));
+    }
+    m_observations.assign(static_cast<size_t>(count) * AquariumEnvLayout::OBSERVATION_SIZE, 0.0f);
+    m_rewards.assign(count, 0.0f);
+    m_dones.assign(count, 0);
+    m_episodeSteps.assign(count, 0);
+    m_lastScore.assign(count, 0);
+    m_lastLives.assign(count, 0);
+    m_lastGameOvers.assign(count, 0);
+    ofLogNotice() << "AquariumEnv: " << count << " environments on " << (m_pool.getWorkerCount() + 1) << " threads";
+}
+
+void AquariumEnv::reset(unsigned int seed) {
+    m_pool.parallelFor(getCount(), [&](int i) {
+        m_shards[i]->reset(seed + i);
+        resetEpisode(i);
+        m_rewards[i] = 0.0f;
+        m_dones[i] = 0;
+        observe(i);
+    });
+}
+
+void AquariumEnv::step(const int* actions) {
+    auto start = std::chrono::steady_clock::now();
+    m_pool.parallelFor(getCount(), [&](int i) {
+        stepOne(i, actions[i]);
+    });
+    m_totalSteps += getCount();
+    m_wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void AquariumEnv::resetEpisode(int index) {
+    AquariumShard& shard = *m_shards[index];
+    m_episodeSteps[index] = 0;
+    m_lastScore[index] = shard.getPlayer()->getScore();
+    m_lastLives[index] = shard.getPlayer()->getLives();
+    m_lastGameOvers[index] = shard.getStats().gameOvers;
+}
+
+// runs on a pool worker; touches nothing but environment `index`
+void AquariumEnv::stepOne(int index, int action) {
+    AquariumShard& shard = *m_shards[index];
+    if (action < 0 || action >= ACTION_COUNT) action = 0;
+    const int* direction = ACTION_DIRECTIONS[action];
+
+    float reward = 0.0f;
+    bool done = false;
+    for (int t = 0; t < m_config.ticksPerStep && !done; ++t) {
+        PlayerCreature& player = *shard.getPlayer();
+        player.setDirection(direction[0], direction[1]);
+        if (direction[0] != 0) player.setFlipped(direction[0] < 0);
+        shard.tick(1.0f / 60.0f);
+
+        if (shard.getStats().gameOvers != m_lastGameOvers[index]) {
+            reward -= m_config.lifePenalty * m_lastLives[index]; // the lives the last hit took
+            done = true;
+            break;
+        }
+        // no game over, so this is still the player that was steered
+        reward += player.getScore() - m_lastScore[index];
+        reward -= m_config.lifePenalty * (m_lastLives[index] - player.getLives());
+        m_lastScore[index] = player.getScore();
+        m_lastLives[index] = player.getLives();
+    }
+
+    ++m_episodeSteps[index];
+    if (!done && m_config.maxEpisodeSteps > 0 && m_episodeSteps[index] >= m_config.maxEpisodeSteps) {
+        shard.reset(); // truncated; the rng carries on, so the next episode differs
+        done = true;
+    }
+    if (done) resetEpisode(index);
+    m_rewards[index] = reward;
+    m_dones[index] = done ? 1 : 0;
+    observe(index);
+}
+
+// the nearest creatures come from one pass with a small insertion-sorted window
+void AquariumEnv::observe(int index) {
+    using Layout = AquariumEnvLayout;
+    AquariumShard& shard = *m_shards[index];
+    std::shared_ptr<Aquarium> aquarium = shard.getAquarium();
+    std::shared_ptr<PlayerCreature> player = shard.getPlayer();
+    float* row = m_observations.data() + static_cast<size_t>(index) * Layout::OBSERVATION_SIZE;
+    std::fill(row, row + Layout::OBSERVATION_SIZE, 0.0f);
+
+    float px = player->getCenterX(), py = player->getCenterY();
+    row[0] = px / aquarium->getWidth();
+    row[1] = py / aquarium->getHeight();
+    row[2] = player->getDx();
+    row[3] = player->getDy();
+    row[4] = player->getPower();
+    row[5] = player->isPredatorMode() ? 1.0f : 0.0f;
+    row[6] = player->isDamageDebounced() ? 1.0f : 0.0f;
+    row[7] = player->getCollisionRadius() / 100.0f;
+    row[Layout::SCORE] = player->getScore();
+    row[Layout::LIVES] = player->getLives();
+
+    const Creature* nearest[Layout::NEAREST_CREATURES];
+    float nearestDistance[Layout::NEAREST_CREATURES];
+    int found = 0;
+    for (const std::shared_ptr<Creature>& creature : aquarium->getCreatures()) {
+        float dx = creature->getCenterX() - px, dy = creature->getCenterY() - py;
+        float distance = dx * dx + dy * dy;
+        if (found == Layout::NEAREST_CREATURES && distance >= nearestDistance[found - 1]) continue;
+        int slot = found < Layout::NEAREST_CREATURES ? found++ : found - 1;
+        while (slot > 0 && nearestDistance[slot - 1] > distance) {
+            nearest[slot] = nearest[slot - 1];
+            nearestDistance[slot] = nearestDistance[slot - 1];
+            --slot;
+        }
+        nearest[slot] = creature.get();
+        nearestDistance[slot] = distance;
+    }
+
+    for (int i = 0; i < found; ++i) {
+        const Creature& creature = *nearest[i];
+        bool dangerous = IsDangerousToPlayer(creature, *player);
+
+        float* features = row + Layout::CREATURES + i * Layout::CREATURE_FEATURES;
+        features[0] = 1.0f;
+        features[1] = (creature.getCenterX() - px) / 512.0f;
+        features[2] = (creature.getCenterY() - py) / 512.0f;
+        features[3] = creature.getDx();
+        features[4] = creature.getDy();
+        features[5] = creature.getValue();
+        features[6] = dangerous ? 1.0f : 0.0f;
+    }
+}
+
+double AquariumEnv::getStepsPerSecond() const {
+    if (m_wallSeconds <= 0.0) return 0.0;
+    return m_totalSteps / m_wallSeconds;
+}
+
+double RunEnvBenchmark(int count, int steps, unsigned int seed) {
+    AquariumEnv env(count);
+    env.reset(seed);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, AquariumEnv::ACTION_COUNT - 1);
+    std::vector<int> actions(count);
+    unsigned long episodes = 0;
+    for (int step = 0; step < steps; ++step) {
+        for (int& action : actions) action = pick(rng);
+        env.step(actions.data());
+        for (int i = 0; i < count; ++i) episodes += env.getDones()[i];
+    }
+    ofLogNotice("env") << count << " environments x " << steps << " steps (" << env.getConfig().ticksPerStep
+        << " ticks each), random actions: " << env.getStepsPerSecond() << " steps/s, " << episodes << " episodes ended";
+    return env.getStepsPerSecond();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "AquariumHost.h"
+
+
+// Layout of one observation row, all floats:
+//   [0, PLAYER_FEATURES)   player: x, y (0..1 of the tank), dx, dy, power, predator mode,
+//                          damage debounce, collision radius / 100
+//   then SCORE, LIVES      raw values
+//   then NEAREST_CREATURES slots of CREATURE_FEATURES, closest first:
+//                          present, relative x, y (per 512 units), dx, dy, value,
+//                          dangerous (touching it would cost a life)
+// Empty creature slots are all zero.
+struct AquariumEnvLayout {
+    static constexpr int PLAYER_FEATURES = 8;
+    static constexpr int SCORE = PLAYER_FEATURES;
+    static constexpr int LIVES = PLAYER_FEATURES + 1;
+    static constexpr int NEAREST_CREATURES = 8;
+    static constexpr int CREATURE_FEATURES = 7;
+    static constexpr int CREATURES = PLAYER_FEATURES + 2;
+    static constexpr int OBSERVATION_SIZE = CREATURES + NEAREST_CREATURES * CREATURE_FEATURES;
+};
+
+struct AquariumEnvConfig {
+    int width = 1024;
+    int height = 768;
+    int ticksPerStep = 6;     // the action repeats this many ticks; 6 is one collision check (AwaitFrames{5})
+    int maxEpisodeSteps = 0;  // 0 means episodes only end at game over
+    float lifePenalty = 10.0f; // reward lost per life lost
+    unsigned int workers = 0; // thread pool size, 0 picks one per spare core
+};
+
+// Batched, headless training environment over N aquarium shards. step() takes one
+// discrete action per environment (0 = stay, 1..8 = the eight directions clockwise
+// from up), runs every environment across the thread pool, and writes observations,
+// rewards and done flags straight into buffers allocated once at construction, so
+// callers can read them in place. Environments that finish are reset on the spot;
+// their row then already holds the first observation of the next episode.
+// The game rules log every sting and level-up at notice level, so training runs
+// should raise the log level first (ofSetLogLevel(OF_LOG_WARNING)).
+class AquariumEnv {
+public:
+    static constexpr int ACTION_COUNT = 9;
+
+    AquariumEnv(int count, const AquariumEnvConfig& config = AquariumEnvConfig());
+
+    void reset(unsigned int seed); // environment i gets seed + i
+    void step(const int* actions);  // one action per environment
+
+    int getCount() const { return static_cast<int>(m_shards.size()); }
+    const AquariumEnvConfig& getConfig() const { return m_config; }
+    // count x OBSERVATION_SIZE, row-major
+    const float* getObservations() const { return m_observations.data(); }
+    const float* getObservation(int index) const { return m_observations.data() + static_cast<size_t>(index) * AquariumEnvLayout::OBSERVATION_SIZE; }
+    const float* getRewards() const { return m_rewards.data(); }
+    const uint8_t* getDones() const { return m_dones.data(); }
+    std::shared_ptr<AquariumShard> getShard(int index) { return m_shards[index]; }
+
+    unsigned long getTotalSteps() const { return m_totalSteps; }
+    double getStepsPerSecond() const; // environment steps, summed over the batch
+
+private:
+    void stepOne(int index, int action);
+    void resetEpisode(int index);
+    void observe(int index);
+
+    AquariumEnvConfig m_config;
+    std::shared_ptr<AquariumSpriteManager> m_spriteManager;
+    std::vector<std::shared_ptr<AquariumShard>> m_shards;
+    ThreadPool m_pool;
+
+    std::vector<float> m_observations;
+    std::vector<float> m_rewards;
+    std::vector<uint8_t> m_dones;
+    // per environment, only touched by the worker stepping it
+    std::vector<int> m_episodeSteps;
+    std::vector<int> m_lastScore;
+    std::vector<int> m_lastLives;
+    std::vector<unsigned long> m_lastGameOvers;
+
+    unsigned long m_totalSteps = 0;
+    double m_wallSeconds = 0.0;
+};
+
+// Steps `count` environments `steps` times with uniformly random actions and logs the
+// throughput under "env"; returns environment steps per second.
+double RunEnvBenchmark(int count, int steps, unsigned int seed = 1);
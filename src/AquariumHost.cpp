@@ -0,0 +1,145 @@
+#include "AquariumHost.h"
+#include <chrono>
+#include <thread>
+
+
+// AquariumShard Implementation
+AquariumShard::AquariumShard(int width, int height, unsigned int seed, std::shared_ptr<AquariumSpriteManager> spriteManager)
+    : m_width(width), m_height(height), m_seed(seed), m_spriteManager(std::move(spriteManager)) {
+    m_aquarium = std::make_shared<Aquarium>(m_width, m_height, m_spriteManager);
+    m_aquarium->setSeed(m_seed);
+    AddDefaultAquariumLevels(m_aquarium);
+    reset();
+}
+
+void AquariumShard::reset() {
+    m_player = std::make_shared<PlayerCreature>(m_width / 2 - 50, m_height / 2 - 50, 5, m_spriteManager->GetSprite(AquariumCreatureType::NPCreature));
+    m_player->setDirection(0, 0);
+    m_player->setBounds(m_width - 20, m_height - 20);
+    m_aquarium->setPlayer(m_player);
+    m_aquarium->reset();
+    m_rules.reset(*m_aquarium);
+}
+
+void AquariumShard::reset(unsigned int seed) {
+    m_seed = seed;
+    m_aquarium->setSeed(seed);
+    reset();
+}
+
+// the game's rules without power-ups, sounds or HUD messages
+void AquariumShard::tick(float deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+
+    m_rules.movePlayers(*m_aquarium, deltaTime, m_player);
+    AquariumRules::Result result = m_rules.resolve(m_aquarium, m_player, [this](const std::shared_ptr<PlayerCreature>&,
+            const std::shared_ptr<GameEvent>& event, const std::shared_ptr<GameEvent>&) {
+        if (event != nullptr) ++m_stats.collisions;
+    });
+    if (result.gameOver) {
+        ++m_stats.gameOvers;
+        reset();
+    }
+
+    ++m_stats.ticks;
+    m_stats.tickSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// headless shards carry no sprites, so they are drawn as hitbox circles
+void AquariumShard::draw() const {
+    if (!m_spriteManager->isHeadless()) {
+        m_aquarium->draw();
+        m_player->draw();
+        return;
+    }
+    ofNoFill();
+    ofSetColor(ofColor::white);
+    for (int i = 0; i < m_aquarium->getCreatureCount(); ++i) {
+        auto creature = m_aquarium->getCreatureAt(i);
+        float r = creature->getCollisionRadius();
+        ofDrawCircle(creature->getCenterX(), creature->getCenterY(), r);
+    }
+    ofSetColor(ofColor::yellow);
+    float r = m_player->getCollisionRadius();
+    ofDrawCircle(m_player->getCenterX(), m_player->getCenterY(), r);
+    ofFill();
+    ofSetColor(ofColor::white);
+}
+
+
+// AquariumHost Implementation
+AquariumHost::AquariumHost(int shardCount, int width, int height, unsigned int baseSeed, unsigned int workers,
+                           std::shared_ptr<AquariumSpriteManager> spriteManager)
+    : m_spriteManager(spriteManager ? spriteManager : std::make_shared<AquariumSpriteManager>(false)), m_pool(workers) {
+    for (int i = 0; i < shardCount; ++i) {
+        m_shards.push_back(std::make_shared<AquariumShard>(width, height, baseSeed + i, m_spriteManager));
+    }
+    ofLogNotice() << "AquariumHost: " << shardCount << " shards on " << (m_pool.getWorkerCount() + 1) << " threads";
+}
+
+void AquariumHost::tick(float deltaTime) {
+    auto start = std::chrono::steady_clock::now();
+    m_pool.parallelFor(getShardCount(), [&](int i) {
+        m_shards[i]->tick(deltaTime);
+    });
+    m_wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void AquariumHost::selectShard(int index) {
+    if (index < 0 || index >= getShardCount()) return;
+    m_selected = index;
+}
+
+void AquariumHost::drawSelected() const {
+    if (m_shards.empty()) return;
+    m_shards[m_selected]->draw();
+    ofDrawBitmapString("Shard " + std::to_string(m_selected) + "/" + std::to_string(getShardCount())
+        + "  tps: " + std::to_string(static_cast<int>(getTicksPerSecond())), 10, 20);
+}
+
+std::shared_ptr<AquariumShard> AquariumHost::getShard(int index) {
+    if (index < 0 || index >= getShardCount()) return nullptr;
+    return m_shards[index];
+}
+
+unsigned long AquariumHost::getTotalTicks() const {
+    unsigned long total = 0;
+    for (const auto& shard : m_shards) {
+        total += shard->getStats().ticks;
+    }
+    return total;
+}
+
+double AquariumHost::getTicksPerSecond() const {
+    if (m_wallSeconds <= 0.0) return 0.0;
+    return getTotalTicks() / m_wallSeconds;
+}
+
+void AquariumHost::logStats() const {
+    for (int i = 0; i < getShardCount(); ++i) {
+        const AquariumShardStats& stats = m_shards[i]->getStats();
+        ofLogNotice("shards") << "shard " << i << " seed " << m_shards[i]->getSeed()
+            << ": ticks " << stats.ticks << ", collisions " << stats.collisions
+            << ", game overs " << stats.gameOvers
+            << ", avg tick " << (stats.ticks ? stats.tickSeconds / stats.ticks * 1e6 : 0.0) << "us";
+    }
+    ofLogNotice("shards") << "aggregate ticks/s: " << getTicksPerSecond();
+}
+
+void RunShardScaling(int shardCount, int ticks, int width, int height) {
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < cores; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(cores);
+
+    double singleThread = 0.0;
+    for (unsigned int threads : threadCounts) {
+        AquariumHost host(shardCount, width, height, 1, threads > 1 ? threads - 1 : ThreadPool::CALLER_ONLY);
+        for (int t = 0; t < ticks; ++t) host.tick();
+        double rate = host.getTicksPerSecond();
+        if (threads == 1) singleThread = rate;
+        ofLogNotice("shards") << shardCount << " shards on " << threads << (threads == 1 ? " thread: " : " threads: ")
+            << rate << " ticks/s, " << (singleThread > 0.0 ? rate / singleThread : 0.0) << "x one thread";
+        if (threads == threadCounts.back()) host.logStats();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include "Aquarium.h"
+#include "ThreadPool.h"
+
+
+// Counters kept by each shard; only the shard's own worker writes them during a tick.
+struct AquariumShardStats {
+    unsigned long ticks = 0;
+    unsigned long collisions = 0;
+    unsigned long gameOvers = 0;
+    double tickSeconds = 0.0; // wall time spent inside tick()
+};
+
+// One independent, headless tank: its own aquarium, player, levels and rng.
+// Shards never touch shared mutable state, so any number of them can tick in parallel.
+class AquariumShard {
+public:
+    AquariumShard(int width, int height, unsigned int seed, std::shared_ptr<AquariumSpriteManager> spriteManager);
+
+    void tick(float deltaTime);
+    void draw() const;
+    void reset();
+    void reset(unsigned int seed); // reseeds first, so the same seed replays the same episode
+
+    std::shared_ptr<Aquarium> getAquarium() { return m_aquarium; }
+    // replaced on every reset, which tick() does itself at game over, so look it up again each tick
+    std::shared_ptr<PlayerCreature> getPlayer() { return m_player; }
+    const AquariumShardStats& getStats() const { return m_stats; }
+    unsigned int getSeed() const { return m_seed; }
+
+private:
+    int m_width;
+    int m_height;
+    unsigned int m_seed;
+    std::shared_ptr<AquariumSpriteManager> m_spriteManager;
+    std::shared_ptr<Aquarium> m_aquarium;
+    std::shared_ptr<PlayerCreature> m_player;
+    AquariumRules m_rules;
+    AquariumShardStats m_stats;
+};
+
+// Owns N shards and ticks them across a thread pool. One shard at a time can be
+// selected for drawing; the others only simulate. Sprites are immutable and shared,
+// so passing the game's sprite manager lets the selected shard draw real sprites.
+class AquariumHost {
+public:
+    AquariumHost(int shardCount, int width, int height, unsigned int baseSeed, unsigned int workers = 0,
+                 std::shared_ptr<AquariumSpriteManager> spriteManager = nullptr);
+
+    void tick(float deltaTime = 1.0f / 60.0f); // advances every shard by one tick
+    void selectShard(int index);
+    int getSelectedShard() const { return m_selected; }
+    void drawSelected() const;
+
+    std::shared_ptr<AquariumShard> getShard(int index);
+    int getShardCount() const { return static_cast<int>(m_shards.size()); }
+    unsigned long getTotalTicks() const;
+    double getTicksPerSecond() const; // aggregate over all shards since construction
+    void logStats() const;
+
+private:
+    std::vector<std::shared_ptr<AquariumShard>> m_shards;
+    std::shared_ptr<AquariumSpriteManager> m_spriteManager;
+    ThreadPool m_pool;
+    int m_selected = 0;
+    double m_wallSeconds = 0.0;
+};
+
+// Ticks the same shards and seeds on 1, 2, 4... threads up to one per core, logging the
+// aggregate ticks/s and the speedup over one thread for each, then logStats() of the
+// widest run.
+void RunShardScaling(int shardCount, int ticks, int width = 1024, int height = 768);
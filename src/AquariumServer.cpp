@@ -0,0 +1,560 @@
+#include "AquariumServer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+
+static void writeHeader(ByteWriter& out, NetMessage message) {
+    out.u16(NET_PROTOCOL_ID);
+    out.u8(static_cast<uint8_t>(message));
+}
+
+static uint8_t entityFlags(const Creature& creature) {
+    return creature.getRenderState().flipped ? NET_FLIPPED : 0;
+}
+
+uint16_t QuantizeNetPosition(float value) {
+    float scaled = std::round(value * NET_POSITION_SCALE);
+    return static_cast<uint16_t>(std::min(std::max(scaled, 0.0f), 65535.0f));
+}
+
+const NetEntity* NetSnapshot::find(uint32_t id) const {
+    auto it = std::lower_bound(entities.begin(), entities.end(), id, [](const NetEntity& entity, uint32_t value) {
+        return entity.id < value;
+    });
+    return it != entities.end() && it->id == id ? &*it : nullptr;
+}
+
+// Both lists are sorted by id, so one merge walk finds the removed entities and
+// another the added and changed ones; each list is counted before it is written.
+void EncodeSnapshot(const NetSnapshot& current, const NetSnapshot* baseline, ByteWriter& out) {
+    static const std::vector<NetEntity> none;
+    const std::vector<NetEntity>& base = baseline ? baseline->entities : none;
+    const std::vector<NetEntity>& now = current.entities;
+
+    auto forEachRemoved = [&](auto&& visit) {
+        size_t j = 0;
+        for (const NetEntity& old : base) {
+            while (j < now.size() && now[j].id < old.id) ++j;
+            if (j == now.size() || now[j].id != old.id) visit(old);
+        }
+    };
+    // new entities carry every field, so they always have a nonzero mask
+    auto forEachChanged = [&](auto&& visit) {
+        size_t i = 0;
+        for (const NetEntity& entity : now) {
+            while (i < base.size() && base[i].id < entity.id) ++i;
+            const NetEntity* old = i < base.size() && base[i].id == entity.id ? &base[i] : nullptr;
+            uint8_t mask = 0xF;
+            if (old) {
+                mask = (entity.x != old->x ? 1 : 0) | (entity.y != old->y ? 2 : 0)
+                    | (entity.type != old->type ? 4 : 0) | (entity.flags != old->flags ? 8 : 0);
+            }
+            if (mask) visit(entity, old, mask);
+        }
+    };
+
+    uint32_t count = 0;
+    forEachRemoved([&](const NetEntity&) { ++count; });
+    out.varint(count);
+    uint32_t previousId = 0;
+    forEachRemoved([&](const NetEntity& old) {
+        out.varint(old.id - previousId);
+        previousId = old.id;
+    });
+
+    count = 0;
+    forEachChanged([&](const NetEntity&, const NetEntity*, uint8_t) { ++count; });
+    out.varint(count);
+    previousId = 0;
+    forEachChanged([&](const NetEntity& entity, const NetEntity* old, uint8_t mask) {
+        out.varint(entity.id - previousId);
+        previousId = entity.id;
+        out.u8(mask);
+        if (mask & 1) out.zigzag(static_cast<int32_t>(entity.x) - (old ? old->x : 0));
+        if (mask & 2) out.zigzag(static_cast<int32_t>(entity.y) - (old ? old->y : 0));
+        if (mask & 4) out.u8(entity.type);
+        if (mask & 8) out.u8(entity.flags);
+    });
+}
+
+bool DecodeSnapshot(ByteReader& in, const NetSnapshot* baseline, NetSnapshot& out) {
+    static const std::vector<NetEntity> none;
+    const std::vector<NetEntity>& base = baseline ? baseline->entities : none;
+    out.entities.clear();
+
+    thread_local std::vector<uint32_t> removed;
+    removed.clear();
+    uint32_t count = in.varint();
+    if (!in.ok() || count > base.size()) return false;
+    uint32_t id = 0;
+    for (uint32_t k = 0; k < count; ++k) {
+        uint32_t delta = in.varint();
+        if (delta == 0 && k > 0) return false; // ids must strictly increase
+        id += delta;
+        removed.push_back(id);
+    }
+
+    size_t b = 0, r = 0;
+    auto keepBaseline = [&](const NetEntity& entity) {
+        while (r < removed.size() && removed[r] < entity.id) ++r;
+        if (r == removed.size() || removed[r] != entity.id) out.entities.push_back(entity);
+    };
+
+    count = in.varint();
+    if (!in.ok() || count > 65535) return false;
+    id = 0;
+    for (uint32_t k = 0; k < count; ++k) {
+        uint32_t delta = in.varint();
+        if (delta == 0) return false;
+        id += delta;
+        uint8_t mask = in.u8();
+        while (b < base.size() && base[b].id < id) keepBaseline(base[b++]);
+        NetEntity entity;
+        entity.id = id;
+        if (b < base.size() && base[b].id == id) entity = base[b++];
+        if (mask & 1) entity.x = static_cast<uint16_t>(entity.x + in.zigzag());
+        if (mask & 2) entity.y = static_cast<uint16_t>(entity.y + in.zigzag());
+        if (mask & 4) entity.type = in.u8();
+        if (mask & 8) entity.flags = in.u8();
+        if (!in.ok()) return false;
+        out.entities.push_back(entity);
+    }
+    while (b < base.size()) keepBaseline(base[b++]);
+    return in.ok();
+}
+
+
+// AquariumServer Implementation
+AquariumServer::AquariumServer(std::shared_ptr<DatagramChannel> channel, const AquariumServerConfig& config)
+    : m_channel(std::move(channel))
+    , m_config(config)
+    , m_spriteManager(std::make_shared<AquariumSpriteManager>(false)) {
+    m_aquarium = std::make_shared<Aquarium>(m_config.width, m_config.height, m_spriteManager);
+    m_aquarium->setSeed(m_config.seed);
+    AddDefaultAquariumLevels(m_aquarium);
+    m_aquarium->reset();
+    m_rules.reset(*m_aquarium);
+    ofLogNotice() << "AquariumServer: listening on " << m_channel->getAddress().toString();
+}
+
+void AquariumServer::tick() {
+    auto start = std::chrono::steady_clock::now();
+    ++m_tick;
+
+    receive();
+    uint32_t timeoutTicks = static_cast<uint32_t>(m_config.clientTimeout / TICK_SECONDS);
+    for (size_t i = m_clients.size(); i-- > 0;) {
+        if (m_tick - m_clients[i].lastHeardTick > timeoutTicks) {
+            ofLogNotice() << "AquariumServer: player " << m_clients[i].playerId << " timed out";
+            dropClient(i);
+        }
+    }
+    simulate();
+    if (m_config.snapshotInterval <= 1 || m_tick % m_config.snapshotInterval == 0) sendSnapshots();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_tickSeconds += seconds;
+    m_maxTickSeconds = std::max(m_maxTickSeconds, seconds);
+}
+
+void AquariumServer::receive() {
+    NetAddress from;
+    while (m_channel->receive(from, m_incoming)) {
+        handle(from, m_incoming);
+    }
+}
+
+void AquariumServer::handle(const NetAddress& from, const std::vector<uint8_t>& packet) {
+    ByteReader in(packet.data(), packet.size());
+    if (in.u16() != NET_PROTOCOL_ID) return;
+    auto message = static_cast<NetMessage>(in.u8());
+    Client* client = findClient(from);
+
+    if (message == NetMessage::CONNECT) {
+        if (!client) {
+            if (static_cast<int>(m_clients.size()) >= m_config.maxClients) return;
+            m_clients.emplace_back();
+            client = &m_clients.back();
+            client->address = from;
+            client->playerId = m_nextPlayerId++;
+            client->joinedTick = m_tick;
+            spawnPlayer(*client);
+            ofLogNotice() << "AquariumServer: player " << client->playerId << " joined from " << from.toString();
+        }
+        // a repeated CONNECT means the ACCEPT was lost, so it is simply sent again
+        client->lastHeardTick = m_tick;
+        client->stats.packetsReceived++;
+        client->stats.bytesReceived += packet.size();
+        m_packet.clear();
+        ByteWriter out(m_packet);
+        writeHeader(out, NetMessage::ACCEPT);
+        out.u16(client->playerId);
+        out.u32(NET_PLAYER_ID_BASE + client->playerId);
+        out.u16(static_cast<uint16_t>(m_config.width));
+        out.u16(static_cast<uint16_t>(m_config.height));
+        out.u16(static_cast<uint16_t>(m_config.playerSpeed * 100));
+        out.u16(QuantizeNetPosition(client->player->getX()));
+        out.u16(QuantizeNetPosition(client->player->getY()));
+        send(*client, m_packet);
+        return;
+    }
+    if (!client) return;
+    client->lastHeardTick = m_tick;
+    client->stats.packetsReceived++;
+    client->stats.bytesReceived += packet.size();
+
+    if (message == NetMessage::INPUT) {
+        uint32_t ack = in.u32();
+        uint8_t count = in.u8();
+        if (!in.ok()) return;
+        // only ticks still in the history can serve as a baseline
+        if (ack > client->ackedTick && ack <= m_tick && findSnapshot(ack)) client->ackedTick = ack;
+        for (int i = 0; i < count; ++i) {
+            PlayerInput input;
+            input.sequence = in.u32();
+            input.dx = static_cast<int8_t>(in.u8());
+            input.dy = static_cast<int8_t>(in.u8());
+            if (!in.ok()) return;
+            if (input.sequence <= client->lastReceivedInput) continue; // resent copy
+            input.dx = std::max<int8_t>(-1, std::min<int8_t>(1, input.dx));
+            input.dy = std::max<int8_t>(-1, std::min<int8_t>(1, input.dy));
+            client->lastReceivedInput = input.sequence;
+            client->inputs.push_back(input);
+            if (client->inputs.size() > MAX_QUEUED_INPUTS) client->inputs.pop_front();
+        }
+    } else if (message == NetMessage::DISCONNECT) {
+        ofLogNotice() << "AquariumServer: player " << client->playerId << " left";
+        dropClient(client - m_clients.data());
+    }
+}
+
+// mirrors AquariumShard::tick, once per player; every player checks the creatures the
+// previous one left, so two players can never eat the same fish
+void AquariumServer::simulate() {
+    m_players.clear();
+    for (Client& client : m_clients) {
+        if (!client.inputs.empty()) {
+            client.direction = client.inputs.front();
+            client.lastAppliedInput = client.direction.sequence;
+            client.inputs.pop_front();
+        }
+        client.player->setDirection(client.direction.dx, client.direction.dy);
+        if (client.direction.dx != 0) client.player->setFlipped(client.direction.dx < 0);
+        m_players.push_back(client.player);
+    }
+    m_rules.movePlayers(*m_aquarium, TICK_SECONDS, m_players.data(), m_players.size());
+    m_rules.resolve(m_aquarium, m_players.data(), m_players.size(), [this](const std::shared_ptr<PlayerCreature>& player,
+            const std::shared_ptr<GameEvent>&, const std::shared_ptr<GameEvent>& outcome) {
+        if (outcome == nullptr || !outcome->isGameOver()) return;
+        for (Client& client : m_clients) {
+            if (client.player != player) continue;
+            ofLogNotice() << "AquariumServer: player " << client.playerId << " respawns";
+            spawnPlayer(client);
+            break;
+        }
+    });
+}
+
+void AquariumServer::sendSnapshots() {
+    m_historyHead = (m_historyHead + 1) % SNAPSHOT_HISTORY;
+    NetSnapshot& snapshot = m_history[m_historyHead];
+    snapshot.tick = m_tick;
+    snapshot.entities.clear();
+    for (const auto& creature : m_aquarium->getCreatures()) {
+        NetEntity entity;
+        entity.id = creature->getId();
+        entity.x = QuantizeNetPosition(creature->getX());
+        entity.y = QuantizeNetPosition(creature->getY());
+        auto npc = std::dynamic_pointer_cast<NPCreature>(creature);
+        entity.type = static_cast<uint8_t>(npc ? npc->GetType() : AquariumCreatureType::NPCreature);
+        entity.flags = entityFlags(*creature);
+        snapshot.entities.push_back(entity);
+    }
+    for (const Client& client : m_clients) {
+        const PlayerCreature& player = *client.player;
+        NetEntity entity;
+        entity.id = NET_PLAYER_ID_BASE + client.playerId;
+        entity.x = QuantizeNetPosition(player.getX());
+        entity.y = QuantizeNetPosition(player.getY());
+        entity.type = NET_PLAYER_TYPE;
+        entity.flags = entityFlags(player) | (player.isPredatorMode() ? NET_PREDATOR : 0)
+            | (player.isDamageDebounced() ? NET_DAMAGED : 0);
+        snapshot.entities.push_back(entity);
+    }
+    std::sort(snapshot.entities.begin(), snapshot.entities.end(), [](const NetEntity& a, const NetEntity& b) {
+        return a.id < b.id;
+    });
+
+    for (Client& client : m_clients) {
+        const PlayerCreature& player = *client.player;
+        m_packet.clear();
+        ByteWriter out(m_packet);
+        writeHeader(out, NetMessage::SNAPSHOT);
+        out.u32(NET_PLAYER_ID_BASE + client.playerId);
+        out.u32(client.lastAppliedInput);
+        out.varint(static_cast<uint32_t>(std::max(0, player.getScore())));
+        out.u8(static_cast<uint8_t>(std::max(0, std::min(255, player.getLives()))));
+        out.u8(static_cast<uint8_t>(std::max(0, std::min(255, player.getPower()))));
+        out.u16(static_cast<uint16_t>(player.getCollisionRadius() * NET_POSITION_SCALE));
+        const NetSnapshot* baseline = client.ackedTick ? findSnapshot(client.ackedTick) : nullptr;
+        out.u32(m_tick);
+        out.u32(baseline ? baseline->tick : 0);
+        EncodeSnapshot(snapshot, baseline, out);
+        send(client, m_packet);
+    }
+}
+
+// players spread out on a spiral around the middle of the tank
+void AquariumServer::spawnPlayer(Client& client) {
+    if (client.player) m_aquarium->removePlayer(client.player);
+    float angle = client.playerId * 2.4f;
+    float distance = std::min(m_config.width, m_config.height) * 0.3f * std::sqrt((client.playerId % 16) / 16.0f);
+    float x = m_config.width / 2 - 50 + std::cos(angle) * distance;
+    float y = m_config.height / 2 - 50 + std::sin(angle) * distance;
+    client.player = std::make_shared<PlayerCreature>(x, y, m_config.playerSpeed, nullptr);
+    client.player->setDirection(0, 0);
+    client.player->setBounds(m_config.width - 20, m_config.height - 20);
+    m_aquarium->addPlayer(client.player);
+}
+
+void AquariumServer::dropClient(size_t index) {
+    m_aquarium->removePlayer(m_clients[index].player);
+    m_clients.erase(m_clients.begin() + index);
+}
+
+void AquariumServer::send(Client& client, const std::vector<uint8_t>& packet) {
+    if (!m_channel->send(client.address, packet.data(), packet.size())) return;
+    client.stats.packetsSent++;
+    client.stats.bytesSent += packet.size();
+}
+
+AquariumServer::Client* AquariumServer::findClient(const NetAddress& address) {
+    for (Client& client : m_clients) {
+        if (client.address == address) return &client;
+    }
+    return nullptr;
+}
+
+const NetSnapshot* AquariumServer::findSnapshot(uint32_t tick) const {
+    for (const NetSnapshot& snapshot : m_history) {
+        if (snapshot.tick == tick && tick != 0) return &snapshot;
+    }
+    return nullptr;
+}
+
+void AquariumServer::logStats() const {
+    for (const Client& client : m_clients) {
+        double seconds = std::max(1u, m_tick - client.joinedTick) * TICK_SECONDS;
+        ofLogNotice() << "player " << client.playerId << " (" << client.address.toString() << "): "
+            << client.stats.bytesSent / seconds << " B/s down, " << client.stats.bytesReceived / seconds << " B/s up, "
+            << client.inputs.size() << " inputs queued";
+    }
+    ofLogNotice() << "AquariumServer: " << m_clients.size() << " players, avg tick "
+        << getAverageTickSeconds() * 1e6 << "us, max " << m_maxTickSeconds * 1e6 << "us";
+}
+
+
+// AquariumClient Implementation
+AquariumClient::AquariumClient(std::shared_ptr<DatagramChannel> channel, const NetAddress& server)
+    : m_channel(std::move(channel)), m_server(server) {}
+
+void AquariumClient::update(int dx, int dy) {
+    receive();
+    if (!m_predicted) {
+        if (m_connectCooldown-- <= 0) {
+            m_packet.clear();
+            ByteWriter out(m_packet);
+            writeHeader(out, NetMessage::CONNECT);
+            m_channel->send(m_server, m_packet.data(), m_packet.size());
+            m_connectCooldown = 30;
+        }
+        return;
+    }
+
+    PlayerInput input;
+    input.sequence = m_nextInput++;
+    input.dx = static_cast<int8_t>(std::max(-1, std::min(1, dx)));
+    input.dy = static_cast<int8_t>(std::max(-1, std::min(1, dy)));
+    m_pending.push_back(input);
+    if (m_pending.size() > 120) m_pending.pop_front(); // two seconds unanswered; the server has moved on
+    m_predicted->setDirection(input.dx, input.dy);
+    if (input.dx != 0) m_predicted->setFlipped(input.dx < 0);
+    m_predicted->update();
+
+    // the newest few inputs ride along every time, so one lost packet costs nothing
+    m_packet.clear();
+    ByteWriter out(m_packet);
+    writeHeader(out, NetMessage::INPUT);
+    out.u32(m_world.tick);
+    size_t count = std::min<size_t>(m_pending.size(), AquariumServer::MAX_QUEUED_INPUTS);
+    out.u8(static_cast<uint8_t>(count));
+    for (size_t i = m_pending.size() - count; i < m_pending.size(); ++i) {
+        out.u32(m_pending[i].sequence);
+        out.u8(static_cast<uint8_t>(m_pending[i].dx));
+        out.u8(static_cast<uint8_t>(m_pending[i].dy));
+    }
+    m_channel->send(m_server, m_packet.data(), m_packet.size());
+}
+
+void AquariumClient::disconnect() {
+    if (!m_predicted) return;
+    m_packet.clear();
+    ByteWriter out(m_packet);
+    writeHeader(out, NetMessage::DISCONNECT);
+    m_channel->send(m_server, m_packet.data(), m_packet.size());
+    m_predicted = nullptr;
+    m_pending.clear();
+}
+
+void AquariumClient::receive() {
+    NetAddress from;
+    while (m_channel->receive(from, m_incoming)) {
+        if (from != m_server) continue;
+        ByteReader in(m_incoming.data(), m_incoming.size());
+        if (in.u16() != NET_PROTOCOL_ID) continue;
+        auto message = static_cast<NetMessage>(in.u8());
+        if (message == NetMessage::ACCEPT && !m_predicted) {
+            in.u16(); // player id, only for display
+            m_state.entityId = in.u32();
+            int width = in.u16();
+            int height = in.u16();
+            int speed = static_cast<int>(std::lround(in.u16() / 100.0));
+            float x = in.u16() / NET_POSITION_SCALE;
+            float y = in.u16() / NET_POSITION_SCALE;
+            if (!in.ok()) continue;
+            m_predicted = std::make_shared<PlayerCreature>(x, y, speed, nullptr);
+            m_predicted->setDirection(0, 0);
+            m_predicted->setBounds(width - 20, height - 20);
+        } else if (message == NetMessage::SNAPSHOT && m_predicted) {
+            handleSnapshot(in);
+        } else if (message == NetMessage::DISCONNECT) {
+            m_predicted = nullptr;
+            m_pending.clear();
+        }
+    }
+}
+
+void AquariumClient::handleSnapshot(ByteReader& in) {
+    NetPlayerState state;
+    state.entityId = in.u32();
+    state.lastInput = in.u32();
+    state.score = in.varint();
+    state.lives = in.u8();
+    state.power = in.u8();
+    state.collisionRadius = in.u16() / NET_POSITION_SCALE;
+    uint32_t tick = in.u32();
+    uint32_t baselineTick = in.u32();
+    if (!in.ok() || tick <= m_world.tick) return; // late or duplicated
+    const NetSnapshot* baseline = nullptr;
+    if (baselineTick) {
+        baseline = findSnapshot(baselineTick);
+        if (!baseline) return; // the baseline fell out of our history; the next full one will do
+    }
+    if (!DecodeSnapshot(in, baseline, m_decoded) || !in.atEnd()) return;
+    m_decoded.tick = tick;
+    m_historyHead = (m_historyHead + 1) % AquariumServer::SNAPSHOT_HISTORY;
+    m_history[m_historyHead] = m_decoded;
+    m_world = m_decoded;
+    m_state = state;
+
+    // rewind to the server's position and replay what it has not applied yet
+    const NetEntity* self = m_world.find(state.entityId);
+    if (!self) return;
+    while (!m_pending.empty() && m_pending.front().sequence <= state.lastInput) m_pending.pop_front();
+    float predictedX = m_predicted->getX(), predictedY = m_predicted->getY();
+    m_predicted->setPosition(self->getX(), self->getY());
+    m_predicted->setCollisionRadius(state.collisionRadius);
+    for (const PlayerInput& input : m_pending) {
+        m_predicted->setDirection(input.dx, input.dy);
+        m_predicted->update();
+    }
+    float correction = std::hypot(m_predicted->getX() - predictedX, m_predicted->getY() - predictedY);
+    m_correctionTotal += correction;
+    m_maxCorrection = std::max(m_maxCorrection, correction);
+    ++m_corrections;
+}
+
+const NetSnapshot* AquariumClient::findSnapshot(uint32_t tick) const {
+    for (const NetSnapshot& snapshot : m_history) {
+        if (snapshot.tick == tick && tick != 0) return &snapshot;
+    }
+    return nullptr;
+}
+
+
+ServerLoadReport RunServerLoadTest(int bots, int seconds, bool useUdp, float loss) {
+    std::shared_ptr<LoopbackNetwork> network;
+    std::shared_ptr<DatagramChannel> serverChannel;
+    std::vector<std::shared_ptr<DatagramChannel>> botChannels;
+    if (useUdp) {
+        auto udp = std::make_shared<UdpChannel>();
+        if (!udp->open(0)) {
+            ofLogError() << "RunServerLoadTest: could not open a UDP socket";
+            return ServerLoadReport();
+        }
+        serverChannel = udp;
+        for (int i = 0; i < bots; ++i) {
+            auto channel = std::make_shared<UdpChannel>();
+            if (!channel->open(0)) break;
+            botChannels.push_back(channel);
+        }
+    } else {
+        network = std::make_shared<LoopbackNetwork>();
+        network->setLoss(loss);
+        serverChannel = network->open(0);
+        for (int i = 0; i < bots; ++i) botChannels.push_back(network->open(0));
+    }
+
+    AquariumServerConfig config;
+    AquariumServer server(serverChannel, config);
+    std::vector<AquariumClient> clients;
+    clients.reserve(botChannels.size());
+    for (const auto& channel : botChannels) clients.emplace_back(channel, serverChannel->getAddress());
+
+    // bots random-walk, holding each heading for a third of a second to a second
+    std::mt19937 rng(config.seed);
+    std::uniform_int_distribution<int> heading(-1, 1);
+    std::uniform_int_distribution<int> hold(20, 60);
+    std::vector<int> dx(clients.size(), 0), dy(clients.size(), 0), holdTicks(clients.size(), 0);
+    int ticks = seconds * 60;
+    for (int t = 0; t < ticks; ++t) {
+        for (size_t i = 0; i < clients.size(); ++i) {
+            if (--holdTicks[i] <= 0) {
+                dx[i] = heading(rng);
+                dy[i] = heading(rng);
+                holdTicks[i] = hold(rng);
+            }
+            clients[i].update(dx[i], dy[i]);
+        }
+        server.tick();
+    }
+
+    ServerLoadReport report;
+    report.bots = bots;
+    report.averageTickSeconds = server.getAverageTickSeconds();
+    report.maxTickSeconds = server.getMaxTickSeconds();
+    float correction = 0.0f;
+    double down = 0.0, up = 0.0;
+    for (const AquariumClient& client : clients) {
+        if (!client.isConnected()) continue;
+        ++report.connected;
+        correction += client.getAverageCorrection();
+        down += client.getStats().bytesReceived;
+        up += client.getStats().bytesSent;
+    }
+    if (report.connected) {
+        double clientSeconds = static_cast<double>(report.connected) * seconds;
+        report.downBytesPerClientSecond = down / clientSeconds;
+        report.upBytesPerClientSecond = up / clientSeconds;
+        report.averageCorrection = correction / report.connected;
+    }
+    ofLogNotice("server") << "load: " << report.connected << "/" << bots << " bots over " << (useUdp ? "udp" : "loopback")
+        << (loss > 0.0f ? " with " + std::to_string(static_cast<int>(loss * 100)) + "% loss" : "")
+        << ", avg tick " << report.averageTickSeconds * 1e6 << "us (" << report.averageTickSeconds * 60 * 100
+        << "% of a core at 60 Hz), max " << report.maxTickSeconds * 1e6 << "us, "
+        << report.downBytesPerClientSecond << " B/s down and " << report.upBytesPerClientSecond
+        << " B/s up per client, avg correction " << report.averageCorrection;
+    return report;
+}
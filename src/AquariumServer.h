@@ -0,0 +1,215 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <array>
+#include <memory>
+#include <cstdint>
+#include "Aquarium.h"
+#include "NetChannel.h"
+
+
+// Wire protocol. Every datagram starts with NET_PROTOCOL_ID and a NetMessage byte.
+//   CONNECT    client -> server, repeated until accepted
+//   ACCEPT     server -> client: player id, entity id, world size, speed, spawn point
+//   INPUT      client -> server: newest snapshot tick received, then the last few
+//              unacknowledged inputs so a lost packet costs nothing
+//   SNAPSHOT   server -> client: own player state, then the world as a delta against
+//              the snapshot the client last acknowledged (or in full without one)
+//   DISCONNECT either way
+constexpr uint16_t NET_PROTOCOL_ID = 0xA51A;
+
+enum class NetMessage : uint8_t {
+    CONNECT = 1,
+    ACCEPT,
+    INPUT,
+    SNAPSHOT,
+    DISCONNECT
+};
+
+constexpr uint8_t NET_PLAYER_TYPE = 255; // NetEntity::type of players; NPCs use AquariumCreatureType
+constexpr uint32_t NET_PLAYER_ID_BASE = 1u << 24; // player entity ids, above any creature id
+constexpr float NET_POSITION_SCALE = 4.0f; // positions travel in quarter units, so worlds up to 16383 wide
+
+enum NetEntityFlags : uint8_t {
+    NET_FLIPPED = 1,
+    NET_PREDATOR = 2,
+    NET_DAMAGED = 4
+};
+
+// One creature or player as clients see it.
+struct NetEntity {
+    uint32_t id = 0;
+    uint16_t x = 0; // top-left, quantized by NET_POSITION_SCALE
+    uint16_t y = 0;
+    uint8_t type = 0;
+    uint8_t flags = 0;
+
+    float getX() const { return x / NET_POSITION_SCALE; }
+    float getY() const { return y / NET_POSITION_SCALE; }
+};
+
+struct NetSnapshot {
+    uint32_t tick = 0;
+    std::vector<NetEntity> entities; // sorted by id
+
+    const NetEntity* find(uint32_t id) const;
+};
+
+// What the server tells a client about its own player in every snapshot.
+struct NetPlayerState {
+    uint32_t entityId = 0;
+    uint32_t lastInput = 0; // newest input sequence the server has applied
+    uint32_t score = 0;
+    uint8_t lives = 0;
+    uint8_t power = 0;
+    float collisionRadius = 0.0f;
+};
+
+struct PlayerInput {
+    uint32_t sequence = 0;
+    int8_t dx = 0;
+    int8_t dy = 0;
+};
+
+uint16_t QuantizeNetPosition(float value);
+// Snapshot bodies; the caller writes and reads the tick and baseline tick around them.
+// Entities missing from `current` are listed as removed, unchanged ones are skipped and
+// changed ones only carry the fields that differ, positions as small zigzag deltas.
+void EncodeSnapshot(const NetSnapshot& current, const NetSnapshot* baseline, ByteWriter& out);
+bool DecodeSnapshot(ByteReader& in, const NetSnapshot* baseline, NetSnapshot& out); // out.tick is left alone
+
+struct AquariumServerConfig {
+    int width = 1024;
+    int height = 768;
+    int playerSpeed = 5;
+    int snapshotInterval = 3;   // ticks between snapshots, 20 Hz at 60 Hz
+    int maxClients = 64;
+    float clientTimeout = 5.0f; // seconds without a packet before a client is dropped
+    unsigned int seed = 1;
+};
+
+// Authoritative simulation for several players in one aquarium. Clients only send
+// inputs; the server applies one per client per tick, runs the same AquariumRules as the game
+// scene and answers with snapshots. Call tick() 60 times a second.
+class AquariumServer {
+public:
+    static constexpr int SNAPSHOT_HISTORY = 32;
+    static constexpr int MAX_QUEUED_INPUTS = 8;
+    static constexpr float TICK_SECONDS = 1.0f / 60.0f;
+
+    AquariumServer(std::shared_ptr<DatagramChannel> channel, const AquariumServerConfig& config = AquariumServerConfig());
+
+    void tick();
+
+    int getClientCount() const { return static_cast<int>(m_clients.size()); }
+    const NetStats& getClientStats(int index) const { return m_clients[index].stats; }
+    std::shared_ptr<Aquarium> getAquarium() { return m_aquarium; }
+    uint32_t getTick() const { return m_tick; }
+    double getAverageTickSeconds() const { return m_tick ? m_tickSeconds / m_tick : 0.0; }
+    double getMaxTickSeconds() const { return m_maxTickSeconds; }
+    void logStats() const; // per-client bandwidth and tick cost
+
+private:
+    struct Client {
+        NetAddress address;
+        uint16_t playerId = 0;
+        std::shared_ptr<PlayerCreature> player;
+        std::deque<PlayerInput> inputs;
+        uint32_t lastReceivedInput = 0;
+        uint32_t lastAppliedInput = 0;
+        PlayerInput direction; // held until the next input arrives
+        uint32_t ackedTick = 0; // delta baseline, 0 until the client has one
+        uint32_t lastHeardTick = 0;
+        uint32_t joinedTick = 0;
+        NetStats stats;
+    };
+
+    void receive();
+    void handle(const NetAddress& from, const std::vector<uint8_t>& packet);
+    void simulate();
+    void sendSnapshots();
+    void spawnPlayer(Client& client);
+    void dropClient(size_t index);
+    void send(Client& client, const std::vector<uint8_t>& packet);
+    Client* findClient(const NetAddress& address);
+    const NetSnapshot* findSnapshot(uint32_t tick) const;
+
+    std::shared_ptr<DatagramChannel> m_channel;
+    AquariumServerConfig m_config;
+    std::shared_ptr<AquariumSpriteManager> m_spriteManager;
+    std::shared_ptr<Aquarium> m_aquarium;
+    std::vector<Client> m_clients;
+    uint16_t m_nextPlayerId = 1;
+    AquariumRules m_rules{true}; // players respawn instead of ending the tick
+    std::vector<std::shared_ptr<PlayerCreature>> m_players; // scratch for m_rules, in client order
+
+    uint32_t m_tick = 0;
+    std::array<NetSnapshot, SNAPSHOT_HISTORY> m_history; // ring of sent world states
+    int m_historyHead = 0;
+    std::vector<uint8_t> m_packet; // reused send/receive buffers
+    std::vector<uint8_t> m_incoming;
+
+    double m_tickSeconds = 0.0;
+    double m_maxTickSeconds = 0.0;
+};
+
+// Client side: sends inputs, predicts its own player locally with the same movement
+// code, and when a snapshot says which input the server got to, snaps back to the
+// server's position and replays the inputs still in flight.
+class AquariumClient {
+public:
+    AquariumClient(std::shared_ptr<DatagramChannel> channel, const NetAddress& server);
+
+    void update(int dx, int dy); // one 60 Hz client tick with the held direction
+    void disconnect();
+
+    bool isConnected() const { return m_predicted != nullptr; }
+    const NetSnapshot& getWorld() const { return m_world; } // newest authoritative state
+    const NetPlayerState& getPlayerState() const { return m_state; }
+    float getPredictedX() const { return m_predicted ? m_predicted->getX() : 0.0f; }
+    float getPredictedY() const { return m_predicted ? m_predicted->getY() : 0.0f; }
+    // how far reconciliation moved the prediction, on average and at worst
+    float getAverageCorrection() const { return m_corrections ? m_correctionTotal / m_corrections : 0.0f; }
+    float getMaxCorrection() const { return m_maxCorrection; }
+    const NetStats& getStats() const { return m_channel->getStats(); }
+
+private:
+    void receive();
+    void handleSnapshot(ByteReader& in);
+    const NetSnapshot* findSnapshot(uint32_t tick) const;
+
+    std::shared_ptr<DatagramChannel> m_channel;
+    NetAddress m_server;
+    std::shared_ptr<PlayerCreature> m_predicted;
+    uint32_t m_nextInput = 1;
+    std::deque<PlayerInput> m_pending; // sent but not yet applied by the server
+    int m_connectCooldown = 0;
+
+    NetSnapshot m_world;
+    NetPlayerState m_state;
+    std::array<NetSnapshot, AquariumServer::SNAPSHOT_HISTORY> m_history; // baselines the server may delta against
+    int m_historyHead = 0;
+    std::vector<uint8_t> m_packet;
+    std::vector<uint8_t> m_incoming;
+    NetSnapshot m_decoded;
+
+    float m_correctionTotal = 0.0f;
+    float m_maxCorrection = 0.0f;
+    unsigned long m_corrections = 0;
+};
+
+struct ServerLoadReport {
+    int bots = 0;
+    int connected = 0;
+    double averageTickSeconds = 0.0;
+    double maxTickSeconds = 0.0;
+    double downBytesPerClientSecond = 0.0; // server -> each client
+    double upBytesPerClientSecond = 0.0;   // each client -> server
+    float averageCorrection = 0.0f;
+};
+
+// Headless load generator: `bots` clients random-walk against one server for
+// `seconds` of simulated time, over loopback or real UDP on 127.0.0.1. Only the
+// server's tick is timed, so the report says what one core spends per player.
+ServerLoadReport RunServerLoadTest(int bots, int seconds, bool useUdp = false, float loss = 0.0f);
@@ -0,0 +1,179 @@
+#include "AssetCache.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+static std::string s_cacheDirectory = "cache";
+static AssetCacheStats s_stats;
+
+namespace {
+
+constexpr uint32_t COOKED_MAGIC = 0x58505141; // "AQPX"
+constexpr uint32_t COOKED_VERSION = 1;
+
+struct CookedHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint32_t hasMirror;
+};
+
+// read-only view of a whole file; mmap where we have it, a plain read otherwise
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                m_data = static_cast<const unsigned char*>(data);
+                m_size = info.st_size;
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return;
+        m_buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(m_buffer.data()), m_buffer.size());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#endif
+    }
+    ~MappedFile() {
+#ifndef _WIN32
+        if (m_data) munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    std::vector<unsigned char> m_buffer;
+#endif
+};
+
+uint64_t HashBytes(const unsigned char* data, size_t size) {
+    uint64_t hash = 1469598103934665603ull; // FNV-1a
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+ofImageType ImageTypeForChannels(uint32_t channels) {
+    return channels == 4 ? OF_IMAGE_COLOR_ALPHA : channels == 3 ? OF_IMAGE_COLOR : OF_IMAGE_GRAYSCALE;
+}
+
+std::string CookedPath(uint64_t sourceHash, int width, int height) {
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx-%dx%d.px", static_cast<unsigned long long>(sourceHash), width, height);
+    return ofToDataPath(s_cacheDirectory + "/" + name, true);
+}
+
+bool ReadCooked(const std::string& cookedPath, uint64_t sourceHash, ofPixels& pixels, ofPixels* mirrored) {
+    MappedFile file(cookedPath);
+    if (file.size() < sizeof(CookedHeader)) return false;
+    CookedHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != COOKED_MAGIC || header.version != COOKED_VERSION || header.sourceHash != sourceHash) return false;
+    if (mirrored && !header.hasMirror) return false;
+    size_t bytes = static_cast<size_t>(header.width) * header.height * header.channels;
+    if (file.size() < sizeof(header) + bytes * (header.hasMirror ? 2 : 1)) return false;
+
+    const unsigned char* rows = file.data() + sizeof(header);
+    pixels.setFromPixels(rows, header.width, header.height, ImageTypeForChannels(header.channels));
+    if (mirrored) {
+        mirrored->setFromPixels(rows + bytes, header.width, header.height, ImageTypeForChannels(header.channels));
+    }
+    return true;
+}
+
+void WriteCooked(const std::string& cookedPath, uint64_t sourceHash, const ofPixels& pixels, const ofPixels* mirrored) {
+    ofDirectory::createDirectory(ofToDataPath(s_cacheDirectory, true), false, true);
+    std::string temporary = cookedPath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        if (!out) return;
+        CookedHeader header{COOKED_MAGIC, COOKED_VERSION, sourceHash,
+                            static_cast<uint32_t>(pixels.getWidth()), static_cast<uint32_t>(pixels.getHeight()),
+                            static_cast<uint32_t>(pixels.getNumChannels()), mirrored ? 1u : 0u};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(pixels.getData()), pixels.getTotalBytes());
+        if (mirrored) out.write(reinterpret_cast<const char*>(mirrored->getData()), mirrored->getTotalBytes());
+        if (!out) return;
+    }
+    std::rename(temporary.c_str(), cookedPath.c_str()); // readers never see a half-written entry
+}
+
+} // namespace
+
+void SetAssetCacheDirectory(const std::string& directory) {
+    s_cacheDirectory = directory;
+}
+
+const AssetCacheStats& GetAssetCacheStats() {
+    return s_stats;
+}
+
+bool LoadCookedPixels(const std::string& path, int width, int height, ofPixels& pixels, ofPixels* mirrored) {
+    auto start = std::chrono::steady_clock::now();
+    auto finish = [&](bool hit, bool ok) {
+        (hit ? s_stats.hits : s_stats.misses) += 1;
+        s_stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return ok;
+    };
+
+    uint64_t sourceHash = 0;
+    bool cacheEnabled = !s_cacheDirectory.empty();
+    if (cacheEnabled) {
+        MappedFile source(ofToDataPath(path, true));
+        if (source.data()) {
+            sourceHash = HashBytes(source.data(), source.size());
+        } else {
+            cacheEnabled = false; // unreadable here, let ofLoadImage report it
+        }
+    }
+    std::string cookedPath = cacheEnabled ? CookedPath(sourceHash, width, height) : "";
+    if (cacheEnabled && ReadCooked(cookedPath, sourceHash, pixels, mirrored)) {
+        return finish(true, true);
+    }
+
+    // cook: decode, resize and mirror once, then keep the result
+    if (!ofLoadImage(pixels, path)) {
+        return finish(false, false);
+    }
+    if (width > 0 && height > 0 && (pixels.getWidth() != static_cast<size_t>(width) || pixels.getHeight() != static_cast<size_t>(height))) {
+        pixels.resize(width, height);
+    }
+    if (mirrored) {
+        *mirrored = pixels;
+        mirrored->mirror(false, true);
+    }
+    if (cacheEnabled) {
+        WriteCooked(cookedPath, sourceHash, pixels, mirrored);
+    }
+    return finish(false, true);
+}
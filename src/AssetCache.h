@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include "ofMain.h"
+
+
+struct AssetCacheStats {
+    int hits = 0;
+    int misses = 0;       // decoded (and cooked) from the source image
+    double seconds = 0.0; // total time spent inside LoadCookedPixels
+};
+
+// Cooked images live in one file each under the cache directory, named after a
+// hash of the source file's bytes and the target size, so editing a PNG or asking
+// for another size simply misses. A file is a small header followed by raw,
+// already resized (and mirrored) pixel rows, and is memory-mapped on load, so a
+// warm start skips PNG decoding and CPU resampling entirely.
+void SetAssetCacheDirectory(const std::string& directory); // default "cache" in the data folder, "" disables
+
+// Pixels of `path` at width x height (0 keeps the source size). `mirrored`, when
+// given, receives the left-right mirror. Returns false if the source can't be read.
+bool LoadCookedPixels(const std::string& path, int width, int height, ofPixels& pixels, ofPixels* mirrored = nullptr);
+
+const AssetCacheStats& GetAssetCacheStats();
@@ -0,0 +1,288 @@
+#include "AudioSystem.h"
+#include "MemoryStats.h"
+#include <chrono>
+
+
+string SoundEffectToString(SoundEffect e){
+    switch(e){
+        case SoundEffect::EAT: return "EAT";
+        case SoundEffect::STING: return "STING";
+        case SoundEffect::POWER_UP: return "POWER_UP";
+        case SoundEffect::LEVEL_UP: return "LEVEL_UP";
+        default: return "UNKNOWN";
+    }
+}
+
+// WavReader Implementation
+bool WavReader::open(const std::string& path) {
+    m_file.close();
+    m_file.clear();
+    m_file.open(path, std::ios::binary);
+    if (!m_file) return false;
+
+    char riff[12];
+    if (!m_file.read(riff, 12) || std::string(riff, 4) != "RIFF" || std::string(riff + 8, 4) != "WAVE") {
+        ofLogError() << "Not a wav file: " << path;
+        return false;
+    }
+
+    bool hasFormat = false;
+    char header[8];
+    while (m_file.read(header, 8)) {
+        std::string id(header, 4);
+        uint32_t size = static_cast<uint8_t>(header[4]) | static_cast<uint8_t>(header[5]) << 8
+            | static_cast<uint8_t>(header[6]) << 16 | static_cast<uint32_t>(static_cast<uint8_t>(header[7])) << 24;
+        if (id == "fmt ") {
+            char fmt[16];
+            if (size < 16 || !m_file.read(fmt, 16)) return false;
+            int format = static_cast<uint8_t>(fmt[0]) | static_cast<uint8_t>(fmt[1]) << 8;
+            m_channels = static_cast<uint8_t>(fmt[2]) | static_cast<uint8_t>(fmt[3]) << 8;
+            m_sampleRate = static_cast<uint8_t>(fmt[4]) | static_cast<uint8_t>(fmt[5]) << 8 | static_cast<uint8_t>(fmt[6]) << 16;
+            int bits = static_cast<uint8_t>(fmt[14]) | static_cast<uint8_t>(fmt[15]) << 8;
+            if (format != 1 || bits != 16 || m_channels < 1 || m_channels > 2) {
+                ofLogError() << "Only 16-bit PCM mono/stereo wav is supported: " << path;
+                return false;
+            }
+            m_file.seekg(size - 16 + (size & 1), std::ios::cur);
+            hasFormat = true;
+        } else if (id == "data") {
+            if (!hasFormat) return false;
+            m_dataStart = m_file.tellg();
+            m_dataBytes = size;
+            m_bytesRead = 0;
+            return true;
+        } else {
+            m_file.seekg(size + (size & 1), std::ios::cur); // chunks are word aligned
+        }
+    }
+    return false;
+}
+
+size_t WavReader::readFrames(int16_t* out, size_t frames) {
+    size_t frameBytes = m_channels * sizeof(int16_t);
+    size_t bytes = std::min<size_t>(frames * frameBytes, m_dataBytes - m_bytesRead);
+    bytes -= bytes % frameBytes;
+    if (bytes == 0 || !m_file.read(reinterpret_cast<char*>(out), bytes)) return 0;
+    m_bytesRead += bytes;
+    return bytes / frameBytes;
+}
+
+void WavReader::rewind() {
+    m_file.clear();
+    m_file.seekg(m_dataStart);
+    m_bytesRead = 0;
+}
+
+
+// SoundStreamAudioBackend Implementation
+bool SoundStreamAudioBackend::start(AudioSystem& system, int sampleRate, int channels, int bufferFrames) {
+    m_system = &system;
+    ofSoundStreamSettings settings;
+    settings.sampleRate = sampleRate;
+    settings.numOutputChannels = channels;
+    settings.numInputChannels = 0;
+    settings.bufferSize = bufferFrames;
+    settings.setOutListener(this);
+    return m_stream.setup(settings);
+}
+
+void SoundStreamAudioBackend::stop() {
+    m_stream.close();
+}
+
+void SoundStreamAudioBackend::audioOut(ofSoundBuffer& buffer) {
+    m_system->mix(buffer.getBuffer().data(), buffer.getNumFrames());
+}
+
+
+// AudioSystem Implementation
+AudioSystem::AudioSystem() {
+    for (int i = 0; i < SOUND_EFFECT_COUNT; ++i) {
+        synthesizeEffect(static_cast<SoundEffect>(i));
+    }
+}
+
+AudioSystem::~AudioSystem() {
+    close();
+}
+
+void AudioSystem::loadEffect(SoundEffect effect, const std::string& path) {
+    MemoryScope memory(MemoryTag::AUDIO);
+    if (m_started) {
+        ofLogError() << "AudioSystem: effects must be loaded before setup()";
+        return;
+    }
+    WavReader reader;
+    if (!reader.open(ofToDataPath(path))) {
+        ofLogNotice() << "AudioSystem: " << path << " not found, using synthesized " << SoundEffectToString(effect);
+        return;
+    }
+
+    std::vector<float>& samples = m_effects[static_cast<int>(effect)];
+    samples.clear();
+    int16_t frame[2];
+    while (reader.readFrames(frame, 1) == 1) {
+        float left = frame[0] / 32768.0f;
+        float right = reader.getChannels() == 2 ? frame[1] / 32768.0f : left;
+        samples.push_back(left);
+        samples.push_back(right);
+    }
+}
+
+// short sine sweeps so every event has a sound even without effect assets
+void AudioSystem::synthesizeEffect(SoundEffect effect) {
+    float seconds = 0.1f, startHz = 660.0f, endHz = 990.0f;
+    switch (effect) {
+        case SoundEffect::EAT: seconds = 0.08f; startHz = 660.0f; endHz = 990.0f; break;
+        case SoundEffect::STING: seconds = 0.25f; startHz = 220.0f; endHz = 110.0f; break;
+        case SoundEffect::POWER_UP: seconds = 0.3f; startHz = 440.0f; endHz = 1320.0f; break;
+        case SoundEffect::LEVEL_UP: seconds = 0.5f; startHz = 523.0f; endHz = 1046.0f; break;
+    }
+
+    std::vector<float>& samples = m_effects[static_cast<int>(effect)];
+    int frames = static_cast<int>(seconds * SAMPLE_RATE);
+    samples.resize(frames * CHANNELS);
+    float phase = 0.0f;
+    for (int i = 0; i < frames; ++i) {
+        float t = static_cast<float>(i) / frames;
+        phase += 2.0f * PI * (startHz + (endHz - startHz) * t) / SAMPLE_RATE;
+        float value = std::sin(phase) * (1.0f - t) * 0.4f;
+        samples[i * CHANNELS] = value;
+        samples[i * CHANNELS + 1] = value;
+    }
+}
+
+bool AudioSystem::setup(std::unique_ptr<AudioBackend> backend) {
+    MemoryScope memory(MemoryTag::AUDIO);
+    close();
+    m_commands.allocate(64);
+    m_backgroundRing.allocate(STREAM_RING_FRAMES * CHANNELS);
+    m_chunk.assign(STREAM_CHUNK_FRAMES * CHANNELS, 0);
+    m_chunkSamples.assign(STREAM_CHUNK_FRAMES * CHANNELS, 0.0f);
+    for (Voice& voice : m_voices) {
+        voice.active = false;
+    }
+
+    m_backend = std::move(backend);
+    m_started = m_backend->start(*this, SAMPLE_RATE, CHANNELS, BUFFER_FRAMES);
+    if (!m_started) {
+        ofLogError() << "AudioSystem: " << m_backend->getName() << " backend failed to start";
+        m_backend.reset();
+        return false;
+    }
+    ofLogNotice() << "AudioSystem: started on " << m_backend->getName() << " backend";
+    return true;
+}
+
+void AudioSystem::streamBackground(const std::string& path, float volume) {
+    MemoryScope memory(MemoryTag::AUDIO);
+    if (!m_started || m_streaming) return;
+    if (m_streamThread.joinable()) m_streamThread.join(); // a previous stream that gave up
+    if (!m_backgroundReader.open(ofToDataPath(path))) {
+        ofLogError() << "AudioSystem: could not stream " << path;
+        return;
+    }
+    if (m_backgroundReader.getSampleRate() != SAMPLE_RATE) {
+        ofLogWarning() << "AudioSystem: " << path << " is " << m_backgroundReader.getSampleRate()
+            << "Hz, mixer runs at " << SAMPLE_RATE << "Hz";
+    }
+    m_backgroundVolume = volume;
+    m_streaming = true;
+    m_streamThread = std::thread(&AudioSystem::streamLoop, this);
+}
+
+void AudioSystem::close() {
+    if (m_backend) {
+        m_backend->stop(); // no more mix() calls after this
+        m_backend.reset();
+    }
+    m_started = false;
+    m_streaming = false;
+    if (m_streamThread.joinable()) {
+        m_streamThread.join();
+    }
+    m_backgroundReader.close();
+}
+
+void AudioSystem::playEffect(SoundEffect effect, float volume) {
+    if (!m_started) return;
+    EffectCommand command;
+    command.effect = static_cast<int>(effect);
+    command.volume = volume;
+    m_commands.push(command); // a full queue drops the effect rather than block
+}
+
+// keeps the ring topped up one chunk at a time, looping at end of file
+void AudioSystem::streamLoop() {
+    MemoryScope memory(MemoryTag::AUDIO); // the whole thread
+    while (m_streaming) {
+        if (m_backgroundRing.freeSpace() < m_chunkSamples.size()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        size_t frames = m_backgroundReader.readFrames(m_chunk.data(), STREAM_CHUNK_FRAMES);
+        if (frames == 0) {
+            m_backgroundReader.rewind();
+            frames = m_backgroundReader.readFrames(m_chunk.data(), STREAM_CHUNK_FRAMES);
+            if (frames == 0) { // empty or unreadable file; silence from here on is not an underrun
+                ofLogWarning() << "AudioSystem: background stream has no frames";
+                m_streaming = false;
+                return;
+            }
+        }
+
+        int channels = m_backgroundReader.getChannels();
+        for (size_t i = 0; i < frames; ++i) {
+            float left = m_chunk[i * channels] / 32768.0f;
+            float right = channels == 2 ? m_chunk[i * channels + 1] / 32768.0f : left;
+            m_chunkSamples[i * CHANNELS] = left;
+            m_chunkSamples[i * CHANNELS + 1] = right;
+        }
+        m_backgroundRing.write(m_chunkSamples.data(), frames * CHANNELS);
+    }
+}
+
+// Real-time: no allocation, no locks, no I/O.
+void AudioSystem::mix(float* out, size_t frames) {
+    EffectCommand command;
+    while (m_commands.pop(command)) {
+        Voice* slot = &m_voices[0];
+        for (Voice& voice : m_voices) {
+            if (!voice.active) { slot = &voice; break; }
+            if (voice.position > slot->position) slot = &voice; // steal the most finished voice
+        }
+        const std::vector<float>& samples = m_effects[command.effect];
+        slot->samples = samples.data();
+        slot->frames = samples.size() / CHANNELS;
+        slot->position = 0;
+        slot->volume = command.volume;
+        slot->active = slot->frames > 0;
+    }
+
+    size_t wanted = frames * CHANNELS;
+    size_t got = m_backgroundRing.read(out, wanted);
+    if (got < wanted) {
+        if (m_streaming) ++m_underruns;
+        std::fill(out + got, out + wanted, 0.0f);
+    }
+    float backgroundVolume = m_backgroundVolume.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < got; ++i) {
+        out[i] *= backgroundVolume;
+    }
+
+    for (Voice& voice : m_voices) {
+        if (!voice.active) continue;
+        size_t count = std::min(frames, voice.frames - voice.position);
+        const float* source = voice.samples + voice.position * CHANNELS;
+        for (size_t i = 0; i < count * CHANNELS; ++i) {
+            out[i] += source[i] * voice.volume;
+        }
+        voice.position += count;
+        voice.active = voice.position < voice.frames;
+    }
+
+    for (size_t i = 0; i < wanted; ++i) {
+        out[i] = std::max(-1.0f, std::min(1.0f, out[i]));
+    }
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <cstdint>
+#include "ofMain.h"
+
+
+enum class SoundEffect {
+    EAT,
+    STING,
+    POWER_UP,
+    LEVEL_UP
+};
+
+constexpr int SOUND_EFFECT_COUNT = 4;
+
+string SoundEffectToString(SoundEffect e);
+
+// Fixed-capacity single-producer/single-consumer queue. Storage is allocated once
+// up front; push and pop never allocate or lock, so the audio thread can use it.
+template <typename T>
+class SpscRing {
+public:
+    void allocate(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        m_items.assign(size, T());
+        m_mask = size - 1;
+        m_head.store(0);
+        m_tail.store(0);
+    }
+    size_t capacity() const { return m_items.size(); }
+    size_t available() const { return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire); }
+    size_t freeSpace() const { return capacity() - available(); }
+
+    bool push(const T& item) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= capacity()) return false;
+        m_items[head & m_mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& item) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+        item = m_items[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    // bulk variants publish the whole span with a single release
+    size_t write(const T* items, size_t count) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        count = std::min(count, capacity() - (head - m_tail.load(std::memory_order_acquire)));
+        for (size_t i = 0; i < count; ++i) m_items[(head + i) & m_mask] = items[i];
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+    size_t read(T* items, size_t count) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        count = std::min(count, m_head.load(std::memory_order_acquire) - tail);
+        for (size_t i = 0; i < count; ++i) items[i] = m_items[(tail + i) & m_mask];
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> m_items;
+    size_t m_mask = 0;
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+};
+
+// Minimal 16-bit PCM wav reader that can either stream frames or load a whole clip.
+class WavReader {
+public:
+    bool open(const std::string& path);
+    void close() { m_file.close(); }
+    size_t readFrames(int16_t* out, size_t frames); // interleaved, returns frames read
+    void rewind();
+    int getChannels() const { return m_channels; }
+    int getSampleRate() const { return m_sampleRate; }
+
+private:
+    std::ifstream m_file;
+    std::streampos m_dataStart = 0;
+    uint32_t m_dataBytes = 0;
+    uint32_t m_bytesRead = 0;
+    int m_channels = 0;
+    int m_sampleRate = 0;
+};
+
+class AudioSystem;
+
+// Where the mixed output goes. Backends call AudioSystem::mix from their own thread.
+class AudioBackend {
+public:
+    virtual ~AudioBackend() = default;
+    virtual bool start(AudioSystem& system, int sampleRate, int channels, int bufferFrames) = 0;
+    virtual void stop() = 0;
+    virtual string getName() const = 0;
+};
+
+// Sound device output through ofSoundStream.
+class SoundStreamAudioBackend : public AudioBackend, public ofBaseSoundOutput {
+public:
+    bool start(AudioSystem& system, int sampleRate, int channels, int bufferFrames) override;
+    void stop() override;
+    string getName() const override { return "ofSoundStream"; }
+    void audioOut(ofSoundBuffer& buffer) override;
+
+private:
+    ofSoundStream m_stream;
+    AudioSystem* m_system = nullptr;
+};
+
+// No device at all, for headless and CI runs. Nothing is mixed and nothing plays.
+class NullAudioBackend : public AudioBackend {
+public:
+    bool start(AudioSystem& /*system*/, int /*sampleRate*/, int /*channels*/, int /*bufferFrames*/) override { return true; }
+    void stop() override {}
+    string getName() const override { return "null"; }
+};
+
+// Streams the background track from disk in small chunks and mixes preloaded
+// sound effects on the backend's real-time thread. Only the streaming thread
+// touches the file; the audio thread only reads preallocated buffers and queues.
+class AudioSystem {
+public:
+    static constexpr int SAMPLE_RATE = 44100;
+    static constexpr int CHANNELS = 2;
+    static constexpr int BUFFER_FRAMES = 512;
+    static constexpr int STREAM_CHUNK_FRAMES = 4096;
+    static constexpr int STREAM_RING_FRAMES = 4 * STREAM_CHUNK_FRAMES; // ~370ms of music in memory
+    static constexpr int MAX_VOICES = 16;
+
+    AudioSystem();
+    ~AudioSystem();
+
+    // effects must be loaded before setup(); missing files get a synthesized blip
+    void loadEffect(SoundEffect effect, const std::string& path);
+    bool setup(std::unique_ptr<AudioBackend> backend);
+    void streamBackground(const std::string& path, float volume);
+    void close();
+
+    // game thread: queue an effect, never blocks
+    void playEffect(SoundEffect effect, float volume = 1.0f);
+    // audio thread: fill `frames` interleaved stereo frames
+    void mix(float* out, size_t frames);
+
+    string getBackendName() const { return m_backend ? m_backend->getName() : "none"; }
+    unsigned long getUnderruns() const { return m_underruns.load(); }
+
+private:
+    struct EffectCommand {
+        int effect = 0;
+        float volume = 1.0f;
+    };
+    struct Voice {
+        const float* samples = nullptr;
+        size_t frames = 0;
+        size_t position = 0;
+        float volume = 0.0f;
+        bool active = false;
+    };
+
+    void streamLoop();
+    void synthesizeEffect(SoundEffect effect);
+
+    std::unique_ptr<AudioBackend> m_backend;
+    bool m_started = false;
+
+    std::array<std::vector<float>, SOUND_EFFECT_COUNT> m_effects; // interleaved stereo, read-only once started
+    std::array<Voice, MAX_VOICES> m_voices; // audio thread only
+    SpscRing<EffectCommand> m_commands;
+
+    WavReader m_backgroundReader;
+    SpscRing<float> m_backgroundRing;
+    std::vector<int16_t> m_chunk; // streaming thread scratch
+    std::vector<float> m_chunkSamples;
+    std::thread m_streamThread;
+    std::atomic<bool> m_streaming{false};
+    std::atomic<float> m_backgroundVolume{0.5f};
+    std::atomic<unsigned long> m_underruns{0};
+};
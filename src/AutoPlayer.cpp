@@ -0,0 +1,181 @@
+#include "AutoPlayer.h"
+#include "AquariumHost.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+
+static double wallClockSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// AutoPlayer Implementation
+void AutoPlayer::steer(const Aquarium& aquarium, PlayerCreature& player) {
+    float px = player.getCenterX(), py = player.getCenterY();
+    float playerRadius = player.getCollisionRadius();
+    float avoidX = 0.0f, avoidY = 0.0f;
+    const Creature* best = nullptr;
+    const Creature* current = nullptr;
+    float bestScore = 0.0f, currentScore = 0.0f;
+
+    for (const std::shared_ptr<Creature>& creature : aquarium.getCreatures()) {
+        float dx = creature->getCenterX() - px, dy = creature->getCenterY() - py;
+        float distance = std::max(1.0f, std::sqrt(dx * dx + dy * dy));
+        if (IsDangerousToPlayer(*creature, player)) {
+            float gap = distance - playerRadius - creature->getCollisionRadius();
+            if (gap < m_settings.dangerRadius) {
+                float push = 1.0f - std::max(0.0f, gap) / m_settings.dangerRadius;
+                push = push * push * 4.0f; // outweighs any meal up close
+                avoidX -= dx / distance * push;
+                avoidY -= dy / distance * push;
+            }
+            continue;
+        }
+        if (!IsEdibleByPlayer(*creature, player)) continue;
+        if (std::find(m_ignored.begin(), m_ignored.end(), creature->getId()) != m_ignored.end()) continue;
+        float score = creature->getValue() / (distance + 100.0f);
+        if (creature->getId() == m_targetId) {
+            current = creature.get();
+            currentScore = score * m_settings.retargetBias;
+        }
+        if (score > bestScore) {
+            best = creature.get();
+            bestScore = score;
+        }
+    }
+    if (current && currentScore >= bestScore) best = current; // no dithering between two close meals
+    if (!best || best->getId() != m_targetId) {
+        m_targetId = best ? best->getId() : 0;
+        m_closestDistance = std::numeric_limits<float>::max();
+        m_stuckTicks = 0;
+    } else {
+        float distance = std::hypot(best->getCenterX() - px, best->getCenterY() - py);
+        if (distance < m_closestDistance - 1.0f) {
+            m_closestDistance = distance;
+            m_stuckTicks = 0;
+        } else if (++m_stuckTicks > m_settings.giveUpTicks) {
+            m_ignored[m_nextIgnored] = m_targetId;
+            m_nextIgnored = (m_nextIgnored + 1) % static_cast<int>(m_ignored.size());
+            m_targetId = 0; // the next tick picks another
+        }
+    }
+
+    // towards the meal, or with nothing to eat back towards the middle at half weight,
+    // since new fish spawn all around it
+    float headingX = best ? best->getCenterX() - px : aquarium.getWidth() * 0.5f - px;
+    float headingY = best ? best->getCenterY() - py : aquarium.getHeight() * 0.5f - py;
+    float length = std::sqrt(headingX * headingX + headingY * headingY);
+    float weight = best ? 1.0f : (length > 100.0f ? 0.5f : 0.0f);
+    if (length > 0.0f) {
+        headingX *= weight / length;
+        headingY *= weight / length;
+    }
+
+    float wallX = 0.0f, wallY = 0.0f;
+    float margin = m_settings.wallMargin;
+    if (px < margin) wallX += 1.0f - px / margin;
+    if (px > aquarium.getWidth() - margin) wallX -= 1.0f - (aquarium.getWidth() - px) / margin;
+    if (py < margin) wallY += 1.0f - py / margin;
+    if (py > aquarium.getHeight() - margin) wallY -= 1.0f - (aquarium.getHeight() - py) / margin;
+
+    float x = headingX + avoidX + wallX, y = headingY + avoidY + wallY;
+    if (x * x + y * y < 0.0025f) x = y = 0.0f;
+    player.setDirection(x, y); // normalized there
+    if (std::abs(x) > 0.1f) player.setFlipped(x < 0.0f);
+}
+
+
+// SoakMonitor Implementation
+SoakMonitor::SoakMonitor(float samplePeriod, const std::string& csvPath)
+    : m_samplePeriod(std::max(1.0f, samplePeriod)), m_nextSample(m_samplePeriod) {
+    m_startWall = m_periodStartWall = wallClockSeconds();
+    if (!csvPath.empty()) {
+        m_csv.open(csvPath);
+        if (m_csv) {
+            m_csv << "sim_seconds,wall_seconds,ticks,ticks_per_second,avg_tick_us,max_tick_us,rss_bytes,peak_rss_bytes,"
+                     "allocations,frees,live_allocations,period_allocations,allocated_bytes,level,score,creatures,dormant,game_overs\n";
+        } else {
+            ofLogWarning() << "SoakMonitor: could not open " << csvPath;
+        }
+    }
+}
+
+void SoakMonitor::recordTick(float simSeconds, double tickSeconds) {
+    m_simSeconds += simSeconds;
+    ++m_ticks;
+    ++m_periodTicks;
+    m_periodTickSeconds += tickSeconds;
+    m_periodMaxTick = std::max(m_periodMaxTick, tickSeconds);
+}
+
+bool SoakMonitor::poll(const Aquarium& aquarium, const PlayerCreature& player) {
+    if (m_simSeconds < m_nextSample) return false;
+    m_nextSample += m_samplePeriod;
+
+    double now = wallClockSeconds();
+    uint64_t previousAllocations = m_last.allocations.allocations;
+    SoakSample sample;
+    sample.simSeconds = m_simSeconds;
+    sample.wallSeconds = now - m_startWall;
+    sample.ticks = m_ticks;
+    sample.ticksPerSecond = now > m_periodStartWall ? m_periodTicks / (now - m_periodStartWall) : 0.0;
+    sample.averageTickSeconds = m_periodTicks ? m_periodTickSeconds / m_periodTicks : 0.0;
+    sample.maxTickSeconds = m_periodMaxTick;
+    sample.residentBytes = GetResidentBytes();
+    sample.peakResidentBytes = GetPeakResidentBytes();
+    sample.allocations = GetAllocationCounters();
+    sample.periodAllocations = sample.allocations.allocations - previousAllocations;
+    sample.level = aquarium.getCurrentLevel();
+    sample.score = player.getScore();
+    sample.creatures = aquarium.getCreatureCount();
+    sample.dormant = aquarium.getChunks().getDormantCount();
+    sample.gameOvers = m_gameOvers;
+    m_last = sample;
+
+    m_periodStartWall = now;
+    m_periodTicks = 0;
+    m_periodTickSeconds = 0.0;
+    m_periodMaxTick = 0.0;
+
+    ofLogNotice("soak") << static_cast<int>(sample.simSeconds) << "s: " << static_cast<int>(sample.ticksPerSecond) << " ticks/s, tick avg "
+        << sample.averageTickSeconds * 1e6 << "us max " << sample.maxTickSeconds * 1e6 << "us, rss " << sample.residentBytes / 1024
+        << "KB (peak " << sample.peakResidentBytes / 1024 << "KB), allocs " << sample.periodAllocations << " ("
+        << sample.allocations.getLive() << " live), level " << sample.level << ", score " << sample.score
+        << ", creatures " << sample.creatures << "+" << sample.dormant << " dormant, game overs " << sample.gameOvers;
+    if (m_csv) {
+        m_csv << sample.simSeconds << ',' << sample.wallSeconds << ',' << sample.ticks << ',' << sample.ticksPerSecond << ','
+            << sample.averageTickSeconds * 1e6 << ',' << sample.maxTickSeconds * 1e6 << ',' << sample.residentBytes << ','
+            << sample.peakResidentBytes << ',' << sample.allocations.allocations << ',' << sample.allocations.frees << ','
+            << sample.allocations.getLive() << ',' << sample.periodAllocations << ',' << sample.allocations.bytesAllocated << ','
+            << sample.level << ',' << sample.score << ',' << sample.creatures << ',' << sample.dormant << ',' << sample.gameOvers << '\n';
+        m_csv.flush(); // a killed soak still leaves every sample behind
+    }
+    return true;
+}
+
+
+SoakSample RunAutoplaySoak(const SoakConfig& config) {
+    const float tickSeconds = 1.0f / 60.0f;
+    auto spriteManager = std::make_shared<AquariumSpriteManager>(false);
+    AquariumShard shard(config.width, config.height, config.seed, spriteManager);
+    AutoPlayer autoPlayer;
+    SoakMonitor monitor(config.samplePeriod, config.csvPath);
+    ofLogNotice("soak") << "autoplaying a " << config.width << "x" << config.height << " tank for "
+        << (config.seconds > 0.0f ? std::to_string(static_cast<int>(config.seconds)) + " simulated seconds" : std::string("ever"));
+
+    unsigned long ticks = config.seconds > 0.0f ? static_cast<unsigned long>(config.seconds / tickSeconds) : 0;
+    unsigned long gameOvers = 0;
+    for (unsigned long t = 0; ticks == 0 || t < ticks; ++t) {
+        autoPlayer.steer(*shard.getAquarium(), *shard.getPlayer());
+        auto start = std::chrono::steady_clock::now();
+        shard.tick(tickSeconds);
+        monitor.recordTick(tickSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        if (shard.getStats().gameOvers != gameOvers) {
+            gameOvers = shard.getStats().gameOvers;
+            monitor.recordGameOver();
+        }
+        monitor.poll(*shard.getAquarium(), *shard.getPlayer());
+    }
+    return monitor.getLast();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <fstream>
+#include "Aquarium.h"
+#include "MemoryStats.h"
+
+
+struct AutoPlayerSettings {
+    float dangerRadius = 160.0f;  // gap (edge to edge) at which threats start pushing back
+    float wallMargin = 80.0f;     // the tank walls push back inside this distance
+    float retargetBias = 1.5f;    // a new meal must look this much better to switch to it
+    int giveUpTicks = 180;        // a meal that gets no closer for this long is written off
+};
+
+// Drives a PlayerCreature through setDirection the way a player would: towards the
+// most worthwhile meal (value over distance), away from jellyfish and from anything
+// it is still too weak to eat, using the same rules as ResolveAquariumCollision. It
+// only reads the tank, so it can steer the rendered game scene and headless shards alike.
+class AutoPlayer {
+public:
+    explicit AutoPlayer(const AutoPlayerSettings& settings = AutoPlayerSettings()) : m_settings(settings) {}
+
+    void steer(const Aquarium& aquarium, PlayerCreature& player); // once per simulation tick
+
+private:
+    AutoPlayerSettings m_settings;
+    uint32_t m_targetId = 0; // by id, so an eaten target cannot dangle
+    float m_closestDistance = 0.0f; // to the target so far
+    int m_stuckTicks = 0;
+    // recently written-off meals, e.g. fish wedged in a corner the player cannot reach
+    std::array<uint32_t, 4> m_ignored{};
+    int m_nextIgnored = 0;
+};
+
+struct SoakSample {
+    double simSeconds = 0.0;
+    double wallSeconds = 0.0;
+    unsigned long ticks = 0;
+    double ticksPerSecond = 0.0;      // wall clock, over the sample period
+    double averageTickSeconds = 0.0;
+    double maxTickSeconds = 0.0;
+    size_t residentBytes = 0;
+    size_t peakResidentBytes = 0;
+    AllocationCounters allocations;   // totals since start
+    uint64_t periodAllocations = 0;   // new since the previous sample
+    int level = 0;
+    int score = 0;
+    int creatures = 0;
+    int dormant = 0;
+    unsigned long gameOvers = 0;
+};
+
+// Collects tick times and, every samplePeriod seconds of simulated time, one line of
+// memory, allocation and tick-time figures for spotting slow leaks and drift in long
+// runs. Lines go to the "soak" log module and, when a path is given, to a CSV file.
+class SoakMonitor {
+public:
+    SoakMonitor(float samplePeriod = 60.0f, const std::string& csvPath = "");
+
+    void recordTick(float simSeconds, double tickSeconds);
+    void recordGameOver() { ++m_gameOvers; }
+    bool poll(const Aquarium& aquarium, const PlayerCreature& player); // true when it took a sample
+    const SoakSample& getLast() const { return m_last; }
+
+private:
+    float m_samplePeriod;
+    std::ofstream m_csv;
+    double m_simSeconds = 0.0;
+    double m_nextSample;
+    unsigned long m_ticks = 0;
+    unsigned long m_gameOvers = 0;
+    double m_periodTickSeconds = 0.0;
+    double m_periodMaxTick = 0.0;
+    unsigned long m_periodTicks = 0;
+    double m_startWall;
+    double m_periodStartWall;
+    SoakSample m_last;
+};
+
+struct SoakConfig {
+    int width = 6 * 1024;     // the game's world
+    int height = 3 * 768;
+    float seconds = 3600.0f;  // simulated; 0 runs until the process is killed
+    float samplePeriod = 60.0f;
+    unsigned int seed = 1;
+    std::string csvPath;      // optional
+};
+
+// Headless soak: one shard with the autoplayer at the controls, ticked as fast as the
+// core allows. Game overs start a new run in the same process, so leaks accumulate.
+SoakSample RunAutoplaySoak(const SoakConfig& config);
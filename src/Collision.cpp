@@ -0,0 +1,117 @@
+#include "Collision.h"
+#include <cmath>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define AQUARIUM_HAS_AVX2_KERNEL 1
+#endif
+
+
+bool SweptCircleContact(float ax0, float ay0, float ax1, float ay1,
+                        float bx0, float by0, float bx1, float by1,
+                        float radiusSum, float& timeOfImpact) {
+    // work in b's frame: a single point moving along rel0 + t * vel against a circle at the origin
+    float relX = ax0 - bx0;
+    float relY = ay0 - by0;
+    float velX = (ax1 - ax0) - (bx1 - bx0);
+    float velY = (ay1 - ay0) - (by1 - by0);
+
+    float c = relX * relX + relY * relY - radiusSum * radiusSum;
+    if (c <= 0.0f) { // already touching at the start of the interval
+        timeOfImpact = 0.0f;
+        return true;
+    }
+    float a = velX * velX + velY * velY;
+    float b = relX * velX + relY * velY;
+    if (a == 0.0f || b >= 0.0f) return false; // not moving, or moving apart
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) return false;
+
+    float t = (-b - std::sqrt(discriminant)) / a;
+    if (t > 1.0f) return false;
+    timeOfImpact = t;
+    return true;
+}
+
+bool MasksOverlap(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by) {
+    int left = std::max(ax, bx), right = std::min(ax + a.getWidth(), bx + b.getWidth());
+    int top = std::max(ay, by), bottom = std::min(ay + a.getHeight(), by + b.getHeight());
+    if (left >= right || top >= bottom) return false;
+
+    for (int y = top; y < bottom; ++y) {
+        for (int x = left; x < right; x += 64) {
+            uint64_t overlap = a.bitsAt(x - ax, y - ay) & b.bitsAt(x - bx, y - by);
+            int span = right - x;
+            if (span < 64) overlap &= (uint64_t(1) << span) - 1;
+            if (overlap) return true;
+        }
+    }
+    return false;
+}
+
+bool checkPixelCollision(const Creature& a, const Creature& b, float timeOfImpact) {
+    const GameSprite* spriteA = a.getSprite();
+    const GameSprite* spriteB = b.getSprite();
+    if (!spriteA || !spriteB) return true;
+    const CollisionMask& maskA = spriteA->getCollisionMask(a.getRenderState().flipped);
+    const CollisionMask& maskB = spriteB->getCollisionMask(b.getRenderState().flipped);
+    if (maskA.isEmpty() || maskB.isEmpty()) return true;
+
+    const float samples[3] = {timeOfImpact, (timeOfImpact + 1.0f) * 0.5f, 1.0f};
+    for (float t : samples) {
+        int ax = static_cast<int>(std::floor(a.getPrevX() + (a.getX() - a.getPrevX()) * t));
+        int ay = static_cast<int>(std::floor(a.getPrevY() + (a.getY() - a.getPrevY()) * t));
+        int bx = static_cast<int>(std::floor(b.getPrevX() + (b.getX() - b.getPrevX()) * t));
+        int by = static_cast<int>(std::floor(b.getPrevY() + (b.getY() - b.getPrevY()) * t));
+        if (MasksOverlap(maskA, ax, ay, maskB, bx, by)) return true;
+    }
+    return false;
+}
+
+// a circle against a horizontal capsule is a circle against the closest point of its segment
+static int BatchOverlapScalar(float qx, float qy, float qr, const CollisionBatch& batch, int begin, uint64_t* hits) {
+    int count = 0;
+    for (int i = begin; i < batch.size(); ++i) {
+        float dx = std::max(std::fabs(qx - batch.x[i]) - batch.halfLength[i], 0.0f);
+        float dy = qy - batch.y[i];
+        float reach = qr + batch.radius[i];
+        if (dx * dx + dy * dy <= reach * reach) {
+            hits[i / 64] |= uint64_t(1) << (i % 64);
+            ++count;
+        }
+    }
+    return count;
+}
+
+#ifdef AQUARIUM_HAS_AVX2_KERNEL
+__attribute__((target("avx2")))
+static int BatchOverlapAvx2(float qx, float qy, float qr, const CollisionBatch& batch, uint64_t* hits) {
+    const __m256 vqx = _mm256_set1_ps(qx), vqy = _mm256_set1_ps(qy), vqr = _mm256_set1_ps(qr);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    int count = 0;
+    int end = batch.size() & ~7;
+    for (int i = 0; i < end; i += 8) {
+        __m256 dx = _mm256_and_ps(_mm256_sub_ps(vqx, _mm256_loadu_ps(&batch.x[i])), absMask);
+        dx = _mm256_max_ps(_mm256_sub_ps(dx, _mm256_loadu_ps(&batch.halfLength[i])), zero);
+        __m256 dy = _mm256_sub_ps(vqy, _mm256_loadu_ps(&batch.y[i]));
+        __m256 reach = _mm256_add_ps(vqr, _mm256_loadu_ps(&batch.radius[i]));
+        __m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(distance, _mm256_mul_ps(reach, reach), _CMP_LE_OQ)));
+        if (mask) {
+            hits[i / 64] |= uint64_t(mask) << (i % 64); // i is a multiple of 8, so the lanes share a word
+            count += __builtin_popcount(mask);
+        }
+    }
+    return count + BatchOverlapScalar(qx, qy, qr, batch, end, hits);
+}
+#endif
+
+int BatchOverlapTest(float qx, float qy, float qr, const CollisionBatch& batch, std::vector<uint64_t>& hits) {
+    hits.assign((batch.size() + 63) / 64, 0);
+    if (batch.size() == 0) return 0;
+#ifdef AQUARIUM_HAS_AVX2_KERNEL
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) return BatchOverlapAvx2(qx, qy, qr, batch, hits.data());
+#endif
+    return BatchOverlapScalar(qx, qy, qr, batch, 0, hits.data());
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Core.h"
+#include "CollisionMask.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+// Continuous (swept) circle test. Both circles move linearly from (x0, y0) to
+// (x1, y1) over one check interval; returns true if they come within radiusSum
+// of each other at any point, with the earliest contact time in [0, 1].
+bool SweptCircleContact(float ax0, float ay0, float ax1, float ay1,
+                        float bx0, float by0, float bx1, float by1,
+                        float radiusSum, float& timeOfImpact);
+
+// Pixel test for two masks placed with their top-left corners at the given
+// positions: ANDs the overlapping rows 64 columns at a time.
+bool MasksOverlap(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by);
+
+// Narrow phase after a swept circle hit at `timeOfImpact`: tests the sprite masks
+// at that time, halfway to the end of the interval and at the end. Creatures
+// without a sprite mask (headless runs) keep the circle result.
+bool checkPixelCollision(const Creature& a, const Creature& b, float timeOfImpact);
+
+// Structure-of-arrays candidates for BatchOverlapTest: hitbox centers, radii and
+// horizontal capsule half-lengths (0 for circles). Reuse one across calls so the
+// arrays keep their capacity.
+struct CollisionBatch {
+    std::vector<float> x, y, radius, halfLength;
+
+    void clear() { x.clear(); y.clear(); radius.clear(); halfLength.clear(); }
+    void add(float cx, float cy, float r, float capsuleHalfLength) {
+        x.push_back(cx); y.push_back(cy); radius.push_back(r); halfLength.push_back(capsuleHalfLength);
+    }
+    int size() const { return static_cast<int>(x.size()); }
+};
+
+// Tests one query circle against every candidate in `batch`, eight lanes per AVX2
+// iteration when the CPU has it (checked once at runtime), scalar otherwise.
+// Bit i of hits[i / 64] is set when candidate i overlaps; returns the hit count.
+int BatchOverlapTest(float qx, float qy, float qr, const CollisionBatch& batch, std::vector<uint64_t>& hits);
+
+// index of the lowest set bit, for walking the hit words; bits must not be 0
+inline int LowestSetBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    int index = 0;
+    while (!(bits & 1)) { bits >>= 1; ++index; }
+    return index;
+#endif
+}
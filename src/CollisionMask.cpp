@@ -0,0 +1,42 @@
+#include "CollisionMask.h"
+
+
+// CollisionMask Implementation
+CollisionMask::CollisionMask(const ofPixels& pixels, unsigned char alphaThreshold)
+    : m_width(pixels.getWidth()), m_height(pixels.getHeight()) {
+    m_wordsPerRow = (m_width + 63) / 64;
+    m_bits.assign(static_cast<size_t>(m_wordsPerRow) * m_height, 0);
+    int channels = pixels.getNumChannels();
+    const unsigned char* data = pixels.getData();
+    if (!data) {
+        m_width = m_height = 0;
+        return;
+    }
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            // images without alpha count as solid
+            bool hasAlpha = channels == 2 || channels == 4;
+            unsigned char alpha = hasAlpha ? data[(static_cast<size_t>(y) * m_width + x) * channels + channels - 1] : 255;
+            if (alpha >= alphaThreshold) {
+                m_bits[y * m_wordsPerRow + x / 64] |= uint64_t(1) << (x % 64);
+            }
+        }
+    }
+}
+
+bool CollisionMask::test(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) return false;
+    return (m_bits[y * m_wordsPerRow + x / 64] >> (x % 64)) & 1;
+}
+
+uint64_t CollisionMask::bitsAt(int x, int y) const {
+    if (y < 0 || y >= m_height || x >= m_width || x <= -64) return 0;
+    const uint64_t* row = &m_bits[y * m_wordsPerRow];
+    if (x < 0) return row[0] << -x;
+    int word = x / 64, shift = x % 64;
+    uint64_t bits = row[word] >> shift;
+    if (shift != 0 && word + 1 < m_wordsPerRow) {
+        bits |= row[word + 1] << (64 - shift);
+    }
+    return bits;
+}
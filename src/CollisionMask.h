@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "ofMain.h"
+
+
+// 1 bit per pixel (alpha >= threshold), LSB first, each row padded to whole 64-bit words.
+class CollisionMask {
+public:
+    CollisionMask() = default;
+    CollisionMask(const ofPixels& pixels, unsigned char alphaThreshold = 128);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    bool isEmpty() const { return m_width == 0 || m_height == 0; }
+    bool test(int x, int y) const;
+
+    // 64 mask bits of row y starting at column x; bits outside the mask read as 0
+    uint64_t bitsAt(int x, int y) const;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_wordsPerRow = 0;
+    std::vector<uint64_t> m_bits;
+};
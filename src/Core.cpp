@@ -1,12 +1,40 @@
 #include "Core.h"
+#include "AssetCache.h"
+#include "MemoryStats.h"
 
 
-std::shared_ptr<GameSprite> GameSprite::clone() const {
-    return std::make_shared<GameSprite>(m_imagePath, m_widthPixels, m_heightPixels);
+// Creature Inherited Base Behavior
+// pixels come from the asset cache: decoded, resized and mirrored once, then mapped on later runs
+GameSprite::GameSprite(const std::string& imagePath, int width, int height) {
+    MemoryScope memory(MemoryTag::SPRITES);
+    m_imagePath = imagePath;
+    m_widthPixels = width;
+    m_heightPixels = height;
+    m_image.setUseTexture(s_useTextures);
+    m_flippedImage.setUseTexture(s_useTextures);
+    ofPixels pixels, flipped;
+    if (!LoadCookedPixels(imagePath, width, height, pixels, &flipped)) {
+        std::cerr << "Failed to load image: " << imagePath << std::endl;
+        return;
+    }
+    m_image.setFromPixels(pixels);
+    m_flippedImage.setFromPixels(flipped);
+    m_collisionMask = CollisionMask(pixels); // once, from the resized alpha
+    m_flippedCollisionMask = CollisionMask(flipped);
+    if (s_useTextures) { // the camera may draw sprites smaller than this
+        for (ofImage* image : {&m_image, &m_flippedImage}) {
+            image->getTexture().generateMipmap();
+            image->getTexture().setTextureMinMagFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+        }
+        m_textureBytes = 2 * EstimateTextureBytes(pixels.getWidth(), pixels.getHeight(), true);
+        TrackGpuMemory(MemoryTag::SPRITES, m_textureBytes);
+    }
 }
 
+GameSprite::~GameSprite() {
+    TrackGpuMemory(MemoryTag::SPRITES, -m_textureBytes);
+}
 
-// Creature Inherited Base Behavior
 void Creature::setBounds(int w, int h) { m_width = w; m_height = h; }
 void Creature::normalize() {
     float length = std::sqrt(m_dx * m_dx + m_dy * m_dy);
@@ -16,25 +44,6 @@ void Creature::normalize() {
     }
 }
 
-void Creature::bounce() {
-    // should implement boundary controls here
-    if (m_x < 0) {
-        m_x = 0;
-        m_dx = abs(m_dx);
-    } else if (m_x + m_collisionRadius * 2 > m_width) {
-        m_x = m_width - m_collisionRadius * 2;
-        m_dx = -abs(m_dx);
-    }
-    if (m_y < 0) {
-        m_y = 0;
-        m_dy = abs(m_dy);
-    } else if (m_y + m_collisionRadius * 2 > m_height) {
-        m_y = m_height - m_collisionRadius * 2;
-        m_dy = -abs(m_dy);
-    }
-}
-
-
 void GameEvent::print() const {
         
         switch (type) {
@@ -57,6 +66,10 @@ void GameEvent::print() const {
             case GameEventType::GAME_OVER:
                 ofLogVerbose() << "Game Over event." << std::endl;
                 break;
+            case GameEventType::PLAYER_DAMAGED:
+                ofLogVerbose() << "Player damaged at ("
+                << creatureA->getX() << ", " << creatureA->getY() << ")." << std::endl;
+                break;
             case GameEventType::NEW_LEVEL:
                 ofLogVerbose() << "New Game level" << std::endl;
             default:
@@ -65,12 +78,12 @@ void GameEvent::print() const {
         }
 };
 
-// collision detection between two creatures
-bool checkCollision(std::shared_ptr<Creature> a, std::shared_ptr<Creature> b) {
-    float dx = a->getX() - b->getX();
-    float dy = a->getY() - b->getY();
+// collision detection between two creatures, circle to circle around their hitbox centers
+bool checkCollision(const Creature& a, const Creature& b) {
+    float dx = a.getCenterX() - b.getCenterX();
+    float dy = a.getCenterY() - b.getCenterY();
     float distanceSquared = dx * dx + dy * dy;
-    float radiusSum = a->getCollisionRadius() + b->getCollisionRadius();
+    float radiusSum = a.getCollisionRadius() + b.getCollisionRadius();
     return distanceSquared <= radiusSum * radiusSum;
 }
 
@@ -149,7 +162,7 @@ void GameOverScene::Update(){
 }
 
 void GameOverScene::Draw(){
-    ofBackgroundGradient(ofColor::red, ofColor::black);
+    if(GetSoftwareRenderTarget() == nullptr){ofBackgroundGradient(ofColor::red, ofColor::black);}
     this->m_banner->draw(0,0);
 
 }
\ No newline at end of file
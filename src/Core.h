@@ -5,6 +5,8 @@
 #include <cmath>
 #include <algorithm>
 #include "ofMain.h"
+#include "SoftwareRenderer.h"
+#include "CollisionMask.h"
 
 
 class AwaitFrames {
@@ -23,49 +25,80 @@ private:
 	int m_counter;
 };
 
+// Per-instance render state. Creatures own one of these so a single immutable
+// GameSprite per type can be shared by every creature of that type.
+struct SpriteRenderState {
+    bool flipped = false;
+    ofColor tint = ofColor(255, 255, 255);
+    int frame = 0; // reserved for animated sprites; single-frame sprites ignore it
+};
+
 class GameSprite {
 public:
-    GameSprite(const std::string& imagePath, int width, int height) {
-        m_imagePath = imagePath;
-        m_widthPixels = width;
-        m_heightPixels = height;
-        if (!m_image.load(imagePath)) {
-            std::cerr << "Failed to load image: " << imagePath << std::endl;
-        }
-        m_image.resize(width, height);
-        m_flippedImage = m_image;
-        m_flippedImage.mirror(false, true); // Mirror horizontally
-    }
-
-    void draw(float x, float y) const {
-        if (m_flipped) {
-            m_flippedImage.draw(x, y);
-        } else {
-            m_image.draw(x, y);
-        }
+    GameSprite(const std::string& imagePath, int width, int height);
+    ~GameSprite();
+    GameSprite(const GameSprite&) = delete; // shared by pointer; copies would double-count textures
+    GameSprite& operator=(const GameSprite&) = delete;
+
+    void draw(float x, float y) const { drawImage(m_image, x, y); }
+
+    void draw(float x, float y, const SpriteRenderState& state) const {
+        bool tinted = state.tint != ofColor(255, 255, 255);
+        if (tinted) RenderSetColor(state.tint);
+        drawImage(state.flipped ? m_flippedImage : m_image, x, y);
+        if (tinted) RenderSetColor(ofColor::white);
     }
 
-    void setFlipped(bool flipped) { m_flipped = flipped; }
+    // turn off before loading sprites when there is no GL context (software renderer, CI)
+    static void setUseTextures(bool useTextures) { s_useTextures = useTextures; }
 
-    std::shared_ptr<GameSprite> clone() const;
+    int getWidth() const { return m_widthPixels; }
+    int getHeight() const { return m_heightPixels; }
+    const CollisionMask& getCollisionMask(bool flipped) const { return flipped ? m_flippedCollisionMask : m_collisionMask; }
 
 private:
+    static void drawImage(const ofImage& image, float x, float y) {
+        if (SoftwareFramebuffer* target = GetSoftwareRenderTarget()) {
+            const ofPixels& pixels = image.getPixels();
+            const SoftwareTransform& transform = GetSoftwareTransform(); // set by WorldCamera
+            float left = transform.x + x * transform.scale, top = transform.y + y * transform.scale;
+            if (transform.scale == 1.0f) {
+                target->blend(pixels.getData(), pixels.getWidth(), pixels.getHeight(), pixels.getNumChannels(),
+                              static_cast<int>(std::floor(left)), static_cast<int>(std::floor(top)), GetRenderColor());
+            } else {
+                target->blendScaled(pixels.getData(), pixels.getWidth(), pixels.getHeight(), pixels.getNumChannels(),
+                                    left, top, transform.scale, GetRenderColor());
+            }
+            return;
+        }
+        image.draw(x, y);
+    }
+
     ofImage m_image;
     ofImage m_flippedImage;
-    bool m_flipped = false;
+    CollisionMask m_collisionMask;
+    CollisionMask m_flippedCollisionMask;
     std::string m_imagePath;
     int m_widthPixels = 0;
     int m_heightPixels = 0;
+    int64_t m_textureBytes = 0; // estimated, both orientations
+    static inline bool s_useTextures = true;
 };
 
 
 
+enum class AquariumCreatureType;
+template <AquariumCreatureType T> struct CreatureBehavior;
+
 class Creature {
+    template <AquariumCreatureType T> friend struct CreatureBehavior;
 protected:
     Creature(float x, float y, int speed, float collisionRadius, int value,
              std::shared_ptr<GameSprite> sprite)
     : m_x(x)
     , m_y(y)
+    , m_prevX(x)
+    , m_prevY(y)
     , m_dx(0)
     , m_dy(0)
     , m_speed(speed)
@@ -73,18 +106,28 @@ protected:
     , m_height(0)
     , m_collisionRadius(collisionRadius)
     , m_value(value)
-    , m_sprite(std::move(sprite)) {}
+    , m_sprite(std::move(sprite)) {
+        if (m_sprite) setHitboxSize(m_sprite->getWidth(), m_sprite->getHeight());
+    }
 
     float m_x = 0.0f;
     float m_y = 0.0f;
+    float m_prevX = 0.0f; // position at the last collision check, for swept tests
+    float m_prevY = 0.0f;
+    unsigned long m_lastSimTick = 0;
+    uint32_t m_id = 0; // unique within its aquarium, 0 until added
     float m_dx = 0.0f;
     float m_dy = 0.0f;
     float m_speed = 0.0f;
     float m_width = 0.0f;
     float m_height = 0.0f;
     float m_collisionRadius = 0.0f;
+    float m_hitboxOffsetX = -1.0f; // top-left corner to hitbox center; negative means "use the radius"
+    float m_hitboxOffsetY = -1.0f;
+    float m_capsuleHalfLength = 0.0f; // horizontal, 0 for a plain circle
     int m_value = 0;
-    std::shared_ptr<GameSprite> m_sprite;
+    std::shared_ptr<GameSprite> m_sprite; // shared with every creature of the same type
+    SpriteRenderState m_renderState;
 
 public:
     virtual ~Creature() = default;
@@ -96,19 +139,64 @@ public:
 
     float getX() const { return m_x; }
     float getY() const { return m_y; }
+    float getDx() const { return m_dx; }
+    float getDy() const { return m_dy; }
+    float getPrevX() const { return m_prevX; }
+    float getPrevY() const { return m_prevY; }
+    void markCollisionCheckpoint() { m_prevX = m_x; m_prevY = m_y; }
+    // tick this creature last moved on, for the simulation LOD (see CreatureBehavior.h)
+    unsigned long getLastSimTick() const { return m_lastSimTick; }
+    uint32_t getId() const { return m_id; }
+    void setId(uint32_t id) { m_id = id; }
+    void setLastSimTick(unsigned long tick) { m_lastSimTick = tick; }
     int getSpeed() const { return m_speed; }
     void setSpeed(int speed) { m_speed = speed; }
-    void setFlipped(bool flipped) {
-        if (m_sprite) {
-            m_sprite->setFlipped(flipped);
-        }
+    void setFlipped(bool flipped) { m_renderState.flipped = flipped; }
+    void setTint(const ofColor& tint) { m_renderState.tint = tint; }
+    const SpriteRenderState& getRenderState() const { return m_renderState; }
+    void setSprite(std::shared_ptr<GameSprite> sprite) {
+        m_sprite = std::move(sprite);
+        if (m_sprite) setHitboxSize(m_sprite->getWidth(), m_sprite->getHeight());
+    }
+    // centers the hitbox on a w x h sprite drawn from the creature's top-left corner
+    void setHitboxSize(float w, float h) { m_hitboxOffsetX = w * 0.5f; m_hitboxOffsetY = h * 0.5f; }
+    float getCenterX() const { return m_x + (m_hitboxOffsetX >= 0.0f ? m_hitboxOffsetX : m_collisionRadius); }
+    float getCenterY() const { return m_y + (m_hitboxOffsetY >= 0.0f ? m_hitboxOffsetY : m_collisionRadius); }
+    float getPrevCenterX() const { return getCenterX() - m_x + m_prevX; }
+    float getPrevCenterY() const { return getCenterY() - m_y + m_prevY; }
+    float getCapsuleHalfLength() const { return m_capsuleHalfLength; }
+    void setCapsuleHalfLength(float halfLength) { m_capsuleHalfLength = halfLength; }
+    const GameSprite* getSprite() const { return m_sprite.get(); }
+    void setDirection(float dx, float dy) { m_dx = dx; m_dy = dy; normalize(); }
+    // teleport: the next swept collision test starts here rather than at the old spot
+    void setPosition(float x, float y) { m_x = m_prevX = x; m_y = m_prevY = y; }
+    // blend a unit steering vector into the current heading
+    void steer(float x, float y, float weight) {
+        if (x == 0.0f && y == 0.0f) return;
+        setDirection(m_dx + x * weight, m_dy + y * weight);
     }
-    void setSprite(std::shared_ptr<GameSprite> sprite) { m_sprite = std::move(sprite); }
     int getValue() const { return m_value; }
 
     void setBounds(int w, int h);
     void normalize();
-    void bounce();
+    // inline so the static creature behaviors can fold it into their loops
+    void bounce() {
+        // should implement boundary controls here
+        if (m_x < 0) {
+            m_x = 0;
+            m_dx = abs(m_dx);
+        } else if (m_x + m_collisionRadius * 2 > m_width) {
+            m_x = m_width - m_collisionRadius * 2;
+            m_dx = -abs(m_dx);
+        }
+        if (m_y < 0) {
+            m_y = 0;
+            m_dy = abs(m_dy);
+        } else if (m_y + m_collisionRadius * 2 > m_height) {
+            m_y = m_height - m_collisionRadius * 2;
+            m_dy = -abs(m_dy);
+        }
+    }
 
 };
 
@@ -121,6 +209,7 @@ enum class GameEventType {
     GAME_OVER,
     GAME_EXIT,
     NEW_LEVEL,
+    PLAYER_DAMAGED,
 };
 
 class GameEvent {
@@ -141,6 +230,7 @@ class GameEvent {
     bool isCreatureRemovedEvent() const { return type == GameEventType::CREATURE_REMOVED; }
     bool isGameOver() const { return type == GameEventType::GAME_OVER; }
     bool isGameExit() const { return type == GameEventType::GAME_EXIT; }
+    bool isPlayerDamagedEvent() const { return type == GameEventType::PLAYER_DAMAGED; }
     bool isNoneEvent() const { return type == GameEventType::NONE; }
     
     // i want a printable representation of the event, with the creature descriptions if available
@@ -150,7 +240,7 @@ class GameEvent {
 
 
 
-bool checkCollision(std::shared_ptr<Creature> a, std::shared_ptr<Creature> b);
+bool checkCollision(const Creature& a, const Creature& b);
 
 
 class GameLevel {
@@ -173,6 +263,8 @@ class GameScene {
         virtual string GetName() = 0;
         virtual void Update() = 0;
         virtual void Draw() = 0;
+        // nothing changes until input arrives, so the app may reuse the last frame and sleep
+        virtual bool IsStatic() { return false; }
         virtual ~GameScene() = default;
 
 };
@@ -192,6 +284,7 @@ class GameIntroScene : public GameScene {
         string GetName() override {return this->m_name;}
         void Update() override;
         void Draw() override;
+        bool IsStatic() override {return true;}
     private:
         string m_name;
         std::shared_ptr<GameSprite> m_banner;
@@ -204,6 +297,7 @@ class GameOverScene : public GameScene {
         string GetName() override {return this->m_name;}
         void Update() override;
         void Draw() override;
+        bool IsStatic() override {return true;}
     private:
         string m_name;
         std::shared_ptr<GameSprite> m_banner;
@@ -0,0 +1,73 @@
+#include "CreatureBehavior.h"
+#include "Aquarium.h"
+#include <chrono>
+
+
+void SelectDueCreatures(const CreatureBuckets& buckets, const FlowField& field, const SimulationLod& lod,
+                        unsigned long tick, CreatureBuckets& due) {
+    unsigned long interval = static_cast<unsigned long>(std::max(1, lod.farInterval));
+    for (int t = 0; t < AQUARIUM_CREATURE_TYPE_COUNT; ++t) {
+        std::vector<Creature*>& out = due[t];
+        out.clear();
+        bool predator = t == static_cast<int>(AquariumCreatureType::BiggerFish);
+        for (Creature* creature : buckets[t]) {
+            float cx = creature->getCenterX(), cy = creature->getCenterY();
+            const FlowCell& cell = field.sample(cx, cy);
+            bool near = cell.playerDistance <= lod.nearCells || (!predator && cell.threatDistance <= FLEE_RADIUS_CELLS);
+            unsigned long owed = tick - creature->getLastSimTick();
+            // far creatures in the same 4x4-cell block share a phase, so nearby schoolmates move together
+            int block = static_cast<int>(cx / (FlowField::CELL_SIZE * 4)) + static_cast<int>(cy / (FlowField::CELL_SIZE * 4));
+            bool phase = static_cast<unsigned long>(std::max(0, block)) % interval == tick % interval;
+            if (near || owed >= interval || phase) {
+                out.push_back(creature);
+            }
+        }
+    }
+}
+
+void BenchmarkCreatureBehaviors(int creatures, int ticks) {
+    auto aquarium = std::make_shared<Aquarium>(1024, 768, std::make_shared<AquariumSpriteManager>(false));
+    aquarium->setSeed(1);
+    for (int i = 0; i < creatures; ++i) {
+        aquarium->SpawnCreature(static_cast<AquariumCreatureType>(i % AQUARIUM_CREATURE_TYPE_COUNT));
+    }
+
+    // the old path: one virtual move() per creature in insertion order
+    std::vector<Creature*> mixed;
+    CreatureBuckets buckets;
+    for (const std::shared_ptr<Creature>& creature : aquarium->getCreatures()) {
+        mixed.push_back(creature.get());
+        if (auto npc = std::dynamic_pointer_cast<NPCreature>(creature)) {
+            buckets[static_cast<int>(npc->GetType())].push_back(creature.get());
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (Creature* creature : mixed) {
+            creature->move();
+        }
+    }
+    double virtualSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // everything moveCreatures does per tick, schooling included
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        aquarium->moveCreatures();
+    }
+    double tickSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // the same moves through the static policies, one bucket per type, with no flow field
+    FlowField field;
+    start = std::chrono::steady_clock::now();
+    for (int t = 1; t <= ticks; ++t) {
+        MoveCreatureBuckets(buckets, field, static_cast<unsigned long>(ticks + t)); // after moveCreatures' ticks
+    }
+    double staticSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double moves = static_cast<double>(creatures) * ticks;
+    ofLogNotice("behavior") << creatures << " creatures x " << ticks << " ticks: virtual "
+        << (virtualSeconds / moves * 1e9) << "ns/move, static "
+        << (staticSeconds / moves * 1e9) << "ns/move, moveCreatures with schooling "
+        << (tickSeconds / moves * 1e9) << "ns/creature";
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "Core.h"
+#include "FlowField.h"
+
+
+enum class AquariumCreatureType {
+    NPCreature,
+    BiggerFish,
+    Axolotl,
+    Jellyfish
+};
+
+constexpr int AQUARIUM_CREATURE_TYPE_COUNT = 4;
+
+// Static movement policies, one specialization per AquariumCreatureType.
+// The virtual NPC move() overrides forward here, and Aquarium::moveCreatures runs
+// each policy over a bucket holding only that type, so the calls inline into a
+// plain loop with no per-creature dispatch. Each policy gets the FlowField cell
+// under the creature; a default FlowCell means "no steering".
+template <AquariumCreatureType T> struct CreatureBehavior;
+
+// how far (in flow cells) creatures react, and how hard they turn per tick
+constexpr int FLEE_RADIUS_CELLS = 4;
+constexpr int CHASE_RADIUS_CELLS = 8;
+constexpr float STEER_WEIGHT = 0.35f;
+
+// Simulation level of detail. Creatures within nearCells of the player, or inside a
+// predator's flee radius, move every tick. The rest move once every farInterval ticks
+// and cover the skipped ticks in one scaled step, staggered by 4x4-cell block so a
+// school far away still moves together. `step` in the policies below is that tick count.
+struct SimulationLod {
+    bool enabled = true;
+    int nearCells = 8;
+    int farInterval = 4;
+};
+
+inline float ScaledSteerWeight(float step) { return std::min(1.0f, STEER_WEIGHT * step); }
+
+template <> struct CreatureBehavior<AquariumCreatureType::NPCreature> {
+    static void move(Creature& c, const FlowCell& cell, float step = 1.0f) {
+        // small fish wander on their random heading and scatter from the player and big fish
+        if (cell.threatDistance <= FLEE_RADIUS_CELLS) {
+            c.steer(cell.fleeX, cell.fleeY, ScaledSteerWeight(step));
+        }
+        c.m_x += c.m_dx * c.m_speed * step;
+        c.m_y += c.m_dy * c.m_speed * step;
+        c.setFlipped(c.m_dx < 0);
+        c.bounce();
+    }
+};
+
+template <> struct CreatureBehavior<AquariumCreatureType::BiggerFish> {
+    static void move(Creature& c, const FlowCell& cell, bool playerIsPredator, float step = 1.0f) {
+        // big fish hunt the player, unless the player is in predator mode
+        if (cell.playerDistance <= CHASE_RADIUS_CELLS) {
+            float sign = playerIsPredator ? -1.0f : 1.0f;
+            c.steer(cell.chaseX * sign, cell.chaseY * sign, ScaledSteerWeight(step));
+        }
+        c.m_x += c.m_dx * (c.m_speed * 0.5f) * step; // Moves at half speed
+        c.m_y += c.m_dy * (c.m_speed * 0.5f) * step;
+        c.setFlipped(c.m_dx < 0);
+        c.bounce();
+    }
+};
+
+template <> struct CreatureBehavior<AquariumCreatureType::Axolotl> {
+    static void move(Creature& c, const FlowCell& cell, float step = 1.0f) {
+        // swims side to side along its row, sliding up or down away from threats
+        c.m_x += c.m_dx * c.m_speed * step;
+        if (cell.threatDistance <= FLEE_RADIUS_CELLS) {
+            c.m_y = std::max(0.0f, std::min(c.m_height, c.m_y + cell.fleeY * c.m_speed * 0.5f * step));
+        }
+        if (c.m_x <= 0 || c.m_x >= c.m_width) {
+            // a catch-up step can overshoot the edge; clamp and head inward, like bounce(),
+            // so a creature promoted to single steps out there cannot flip back and forth
+            c.m_x = std::max(0.0f, std::min(c.m_width, c.m_x));
+            c.m_dx = c.m_x <= 0 ? std::abs(c.m_dx) : -std::abs(c.m_dx);
+            c.setFlipped(c.m_dx < 0);
+        }
+    }
+};
+
+template <> struct CreatureBehavior<AquariumCreatureType::Jellyfish> {
+    static void move(Creature& c, const FlowCell& cell, float step = 1.0f) {
+        // drifts up and down its column, edging sideways toward a nearby player
+        c.m_y += c.m_dy * c.m_speed * step;
+        if (cell.playerDistance <= CHASE_RADIUS_CELLS) {
+            c.m_x = std::max(0.0f, std::min(c.m_width, c.m_x + cell.chaseX * step));
+        }
+        if (c.m_y <= 0 || c.m_y >= c.m_height) {
+            c.m_y = std::max(0.0f, std::min(c.m_height, c.m_y)); // as for the axolotl
+            c.m_dy = c.m_y <= 0 ? std::abs(c.m_dy) : -std::abs(c.m_dy);
+        }
+    }
+};
+
+// every creature in the bucket catches up on the ticks since it last moved
+template <AquariumCreatureType T>
+void MoveCreatureBucket(const std::vector<Creature*>& bucket, const FlowField& field, unsigned long tick) {
+    for (Creature* creature : bucket) {
+        float step = static_cast<float>(tick - creature->getLastSimTick());
+        creature->setLastSimTick(tick);
+        CreatureBehavior<T>::move(*creature, field.sample(creature->getCenterX(), creature->getCenterY()), step);
+    }
+}
+
+template <>
+inline void MoveCreatureBucket<AquariumCreatureType::BiggerFish>(const std::vector<Creature*>& bucket, const FlowField& field, unsigned long tick) {
+    bool playerIsPredator = field.isPlayerPredator();
+    for (Creature* creature : bucket) {
+        float step = static_cast<float>(tick - creature->getLastSimTick());
+        creature->setLastSimTick(tick);
+        CreatureBehavior<AquariumCreatureType::BiggerFish>::move(*creature, field.sample(creature->getCenterX(), creature->getCenterY()), playerIsPredator, step);
+    }
+}
+
+using CreatureBuckets = std::array<std::vector<Creature*>, AQUARIUM_CREATURE_TYPE_COUNT>;
+
+// one homogeneous loop per type, in enum order
+inline void MoveCreatureBuckets(const CreatureBuckets& buckets, const FlowField& field, unsigned long tick) {
+    MoveCreatureBucket<AquariumCreatureType::NPCreature>(buckets[static_cast<int>(AquariumCreatureType::NPCreature)], field, tick);
+    MoveCreatureBucket<AquariumCreatureType::BiggerFish>(buckets[static_cast<int>(AquariumCreatureType::BiggerFish)], field, tick);
+    MoveCreatureBucket<AquariumCreatureType::Axolotl>(buckets[static_cast<int>(AquariumCreatureType::Axolotl)], field, tick);
+    MoveCreatureBucket<AquariumCreatureType::Jellyfish>(buckets[static_cast<int>(AquariumCreatureType::Jellyfish)], field, tick);
+}
+
+// Splits each bucket into the creatures due to move on `tick` under `lod`; the
+// rest keep accumulating skipped ticks. Predators are tiered by player distance only.
+void SelectDueCreatures(const CreatureBuckets& buckets, const FlowField& field, const SimulationLod& lod,
+                        unsigned long tick, CreatureBuckets& due);
+
+// Times the virtual move() path against the bucketed static path on a headless
+// aquarium, then a full moveCreatures tick, and logs all three; see --behavior-bench
+// in main.cpp.
+void BenchmarkCreatureBehaviors(int creatures, int ticks);
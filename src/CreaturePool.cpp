@@ -0,0 +1,45 @@
+#include "CreaturePool.h"
+#include <algorithm>
+#include <new>
+
+
+// blocks stay aligned like operator new's, and big enough to hold a free-list link
+static size_t BlockSize(size_t bytes) {
+    const size_t align = alignof(std::max_align_t);
+    return (std::max(bytes, sizeof(void*)) + align - 1) / align * align;
+}
+
+CreaturePool::~CreaturePool() {
+    for (char* slab : m_slabs) {
+        ::operator delete(slab);
+    }
+}
+
+void* CreaturePool::allocate(size_t bytes) {
+    size_t size = BlockSize(bytes);
+    if (m_blockSize == 0) m_blockSize = size;
+    if (size != m_blockSize) return ::operator new(bytes);
+
+    ++m_live;
+    if (m_free) {
+        FreeBlock* block = m_free;
+        m_free = block->next;
+        return block;
+    }
+    if (m_slabs.empty() || m_slabUsed == m_blocksPerSlab) {
+        m_slabs.push_back(static_cast<char*>(::operator new(m_blockSize * m_blocksPerSlab)));
+        m_slabUsed = 0;
+    }
+    return m_slabs.back() + m_blockSize * m_slabUsed++;
+}
+
+void CreaturePool::deallocate(void* block, size_t bytes) {
+    if (BlockSize(bytes) != m_blockSize) {
+        ::operator delete(block);
+        return;
+    }
+    --m_live;
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = m_free;
+    m_free = freed;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+// Fixed-size blocks carved from large slabs. Aquarium keeps one pool per NPC type and
+// allocates each creature (object and shared_ptr control block together) from it, so
+// the bucket moveCreatures walks for a type sits in a few dense slabs rather than
+// interleaved with every other type across the heap. Freed blocks are reused newest
+// first. The block size is fixed by the first allocation; anything else falls through
+// to the heap. Not thread safe: an aquarium creates and drops creatures on one thread.
+class CreaturePool {
+public:
+    explicit CreaturePool(size_t blocksPerSlab = 512) : m_blocksPerSlab(blocksPerSlab) {}
+    ~CreaturePool();
+    CreaturePool(const CreaturePool&) = delete;
+    CreaturePool& operator=(const CreaturePool&) = delete;
+
+    void* allocate(size_t bytes);
+    void deallocate(void* block, size_t bytes);
+
+    size_t getLiveBlocks() const { return m_live; }
+    size_t getSlabCount() const { return m_slabs.size(); }
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    size_t m_blocksPerSlab;
+    size_t m_blockSize = 0;
+    size_t m_live = 0;
+    size_t m_slabUsed = 0; // blocks handed out from the newest slab
+    FreeBlock* m_free = nullptr;
+    std::vector<char*> m_slabs;
+};
+
+// std::allocate_shared adaptor; every copy (including the one inside each control block)
+// keeps the pool alive, so creatures may outlive the aquarium that spawned them.
+template <typename T>
+class CreaturePoolAllocator {
+public:
+    using value_type = T;
+
+    explicit CreaturePoolAllocator(std::shared_ptr<CreaturePool> pool) : m_pool(std::move(pool)) {}
+    template <typename U>
+    CreaturePoolAllocator(const CreaturePoolAllocator<U>& other) : m_pool(other.getPool()) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(m_pool->allocate(n * sizeof(T))); }
+    void deallocate(T* block, size_t n) { m_pool->deallocate(block, n * sizeof(T)); }
+
+    const std::shared_ptr<CreaturePool>& getPool() const { return m_pool; }
+
+    template <typename U>
+    bool operator==(const CreaturePoolAllocator<U>& other) const { return m_pool == other.getPool(); }
+    template <typename U>
+    bool operator!=(const CreaturePoolAllocator<U>& other) const { return m_pool != other.getPool(); }
+
+private:
+    std::shared_ptr<CreaturePool> m_pool;
+};
@@ -0,0 +1,221 @@
+#include "FlightRecorder.h"
+#include "MemoryStats.h"
+#include "ofMain.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+// FlightRecorder Implementation
+FlightRecorder::~FlightRecorder() {
+    close();
+}
+
+#ifndef _WIN32
+bool FlightRecorder::open(const std::string& path, uint32_t capacity) {
+    close();
+    capacity = std::max<uint32_t>(capacity, 2);
+    m_mappingSize = sizeof(Header) + static_cast<size_t>(capacity) * sizeof(FlightRecord);
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0 || ::ftruncate(m_fd, m_mappingSize) != 0) {
+        ofLogError() << "FlightRecorder: could not create " << path;
+        close();
+        return false;
+    }
+    void* mapping = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (mapping == MAP_FAILED) {
+        ofLogError() << "FlightRecorder: could not map " << path;
+        close();
+        return false;
+    }
+    m_mapping = mapping;
+    m_path = path;
+    m_header = static_cast<Header*>(mapping);
+    m_records = reinterpret_cast<FlightRecord*>(m_header + 1);
+    m_capacity = capacity;
+    m_sequence = 0;
+    m_current = nullptr;
+    m_lastStallCopy = 0;
+    m_start = std::chrono::steady_clock::now();
+
+    std::memset(m_header, 0, sizeof(Header)); // the records are already zero from ftruncate
+    m_header->magic = MAGIC;
+    m_header->version = VERSION;
+    m_header->recordSize = sizeof(FlightRecord);
+    m_header->capacity = capacity;
+    m_header->startUnixMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    ofLogNotice() << "FlightRecorder: last " << capacity << " frames in " << path;
+    return true;
+}
+
+void FlightRecorder::close() {
+    if (m_current) commit();
+    if (m_mapping) munmap(m_mapping, m_mappingSize);
+    if (m_fd >= 0) ::close(m_fd);
+    m_mapping = nullptr;
+    m_fd = -1;
+    m_header = nullptr;
+    m_records = nullptr;
+    m_current = nullptr;
+}
+#else
+bool FlightRecorder::open(const std::string& path, uint32_t capacity) {
+    ofLogWarning() << "FlightRecorder: not available on this platform";
+    return false;
+}
+
+void FlightRecorder::close() {}
+#endif
+
+FlightRecord* FlightRecorder::beginFrame(float frameSeconds) {
+    if (!m_records) return nullptr;
+    if (m_current) commit();
+
+    FlightRecord* record = &m_records[m_sequence % m_capacity];
+    *record = FlightRecord();
+    record->sequence = ++m_sequence;
+    record->timeMillis = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_start).count());
+    record->frameSeconds = frameSeconds;
+    m_current = record;
+    m_frameAllocations = GetAllocationCounters().allocations;
+
+    // the lead-up to a stall is copied out before the ring wraps over it, at most every ten seconds
+    if (m_stallSeconds > 0.0f && frameSeconds > m_stallSeconds && m_sequence - m_lastStallCopy > 600) {
+        m_lastStallCopy = m_sequence;
+        std::string copy = m_path + ".stall-" + std::to_string(m_sequence);
+        if (saveCopy(copy)) {
+            ofLogWarning() << "FlightRecorder: " << frameSeconds * 1000.0f << "ms frame, saved " << copy;
+        }
+    }
+    return record;
+}
+
+void FlightRecorder::commit() {
+    FlightRecord* record = m_current;
+    m_current = nullptr;
+    record->allocations = static_cast<uint32_t>(GetAllocationCounters().allocations - m_frameAllocations);
+    // a signal can stop us anywhere; the fields must be in memory before the commit mark
+    std::atomic_signal_fence(std::memory_order_release);
+    record->commit = record->sequence;
+    m_header->head = record->sequence;
+}
+
+void FlightRecorder::addZone(FlightZone zone, double seconds) {
+    if (!m_current) return;
+    uint16_t& slot = m_current->zoneMicros[static_cast<int>(zone)];
+    double micros = slot + seconds * 1e6;
+    slot = static_cast<uint16_t>(std::min(micros, 65535.0));
+}
+
+void FlightRecorder::addEvent(FlightEvent event) {
+    if (!m_current) return;
+    uint8_t& count = m_current->events[static_cast<int>(event)];
+    if (count < 255) ++count;
+}
+
+bool FlightRecorder::saveCopy(const std::string& path) const {
+    if (!m_mapping) return false;
+    std::ofstream out(path, std::ios::binary);
+    out.write(static_cast<const char*>(m_mapping), m_mappingSize);
+    return static_cast<bool>(out);
+}
+
+
+const char* FlightZoneToString(FlightZone zone) {
+    switch (zone) {
+        case FlightZone::UPDATE: return "update";
+        case FlightZone::PLAYER: return "player";
+        case FlightZone::POWER_UPS: return "powerups";
+        case FlightZone::COLLISIONS: return "collide";
+        case FlightZone::STREAM: return "stream";
+        case FlightZone::FLOW_FIELD: return "flow";
+        case FlightZone::MOVE: return "move";
+        case FlightZone::REPOPULATE: return "repop";
+        case FlightZone::DRAW: return "draw";
+        default: return "unknown";
+    }
+}
+
+const char* FlightEventToString(FlightEvent event) {
+    switch (event) {
+        case FlightEvent::COLLISION: return "collision";
+        case FlightEvent::EATEN: return "eaten";
+        case FlightEvent::DAMAGED: return "damaged";
+        case FlightEvent::GAME_OVER: return "game-over";
+        case FlightEvent::LEVEL_UP: return "level-up";
+        case FlightEvent::POWER_UP: return "power-up";
+        default: return "unknown";
+    }
+}
+
+// a plain read, so it also works on copies and on machines without the game's mmap
+bool ReadFlightRecording(const std::string& path, std::vector<FlightRecord>& records) {
+    records.clear();
+    std::ifstream in(path, std::ios::binary);
+    uint32_t header[4] = {};
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != FlightRecorder::MAGIC || (header[1] & 0xFFFF) != FlightRecorder::VERSION
+        || (header[1] >> 16) != sizeof(FlightRecord)) {
+        return false;
+    }
+    uint32_t capacity = header[2];
+    in.seekg(64);
+    std::vector<FlightRecord> ring(capacity);
+    in.read(reinterpret_cast<char*>(ring.data()), static_cast<std::streamsize>(capacity) * sizeof(FlightRecord));
+    ring.resize(in.gcount() / sizeof(FlightRecord)); // tolerate a truncated copy
+
+    for (const FlightRecord& record : ring) {
+        if (record.sequence != 0) records.push_back(record);
+    }
+    std::sort(records.begin(), records.end(), [](const FlightRecord& a, const FlightRecord& b) {
+        return a.sequence < b.sequence;
+    });
+    return true;
+}
+
+bool LogFlightRecording(const std::string& path, size_t count) {
+    std::vector<FlightRecord> records;
+    if (!ReadFlightRecording(path, records)) {
+        ofLogError() << "FlightRecorder: " << path << " is not a flight recording";
+        return false;
+    }
+    size_t first = count && records.size() > count ? records.size() - count : 0;
+    std::string columns = "   frame     ms  frame_ms";
+    for (int zone = 0; zone < FLIGHT_ZONE_COUNT; ++zone) {
+        char column[16];
+        std::snprintf(column, sizeof(column), " %8s", FlightZoneToString(static_cast<FlightZone>(zone)));
+        columns += column;
+    }
+    ofLogNotice("flight") << path << ": " << records.size() << " frames";
+    ofLogNotice("flight") << columns << "  alloc crt lvl score lives  x,y  events";
+    for (size_t i = first; i < records.size(); ++i) {
+        const FlightRecord& record = records[i];
+        char row[256];
+        int length = std::snprintf(row, sizeof(row), "%8u %6u %9.2f", record.sequence, record.timeMillis, record.frameSeconds * 1000.0f);
+        for (int zone = 0; zone < FLIGHT_ZONE_COUNT && length < static_cast<int>(sizeof(row)); ++zone) {
+            length += std::snprintf(row + length, sizeof(row) - length, " %8u", record.zoneMicros[zone]);
+        }
+        std::string line = row;
+        std::snprintf(row, sizeof(row), "  %5u %3u %3u %5d %5u  %d,%d", record.allocations, record.creatures, record.level,
+            record.score, record.lives, record.playerX, record.playerY);
+        line += row;
+        for (int event = 0; event < FLIGHT_EVENT_COUNT; ++event) {
+            if (record.events[event]) line += std::string(" ") + FlightEventToString(static_cast<FlightEvent>(event)) + "x" + std::to_string(record.events[event]);
+        }
+        if (record.inputMillis) line += " input " + std::to_string(record.inputMillis) + "ms";
+        if (record.playerFlags & FLIGHT_PREDATOR) line += " predator";
+        if (!record.isComplete()) line += "  <- interrupted";
+        ofLogNotice("flight") << line;
+    }
+    return true;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+
+// Where a frame's time went. Each zone is timed once per frame, in microseconds.
+enum class FlightZone : uint8_t {
+    UPDATE,      // the whole AquariumGameScene::Update
+    PLAYER,      // clock and player movement
+    POWER_UPS,
+    COLLISIONS,  // detect and resolve
+    STREAM,      // Aquarium::update from here down
+    FLOW_FIELD,
+    MOVE,
+    REPOPULATE,
+    DRAW,
+    COUNT
+};
+constexpr int FLIGHT_ZONE_COUNT = static_cast<int>(FlightZone::COUNT);
+
+enum class FlightEvent : uint8_t {
+    COLLISION,
+    EATEN,
+    DAMAGED,
+    GAME_OVER,
+    LEVEL_UP,
+    POWER_UP,
+    COUNT
+};
+constexpr int FLIGHT_EVENT_COUNT = static_cast<int>(FlightEvent::COUNT);
+
+enum FlightPlayerFlags : uint8_t {
+    FLIGHT_PREDATOR = 1,
+    FLIGHT_DAMAGED = 2,
+    FLIGHT_SPEED_BOOST = 4,
+    FLIGHT_SIZE_BOOST = 8
+};
+
+// One frame, 64 bytes, written in place in the mapped file. `commit` is stored last
+// and equals `sequence` once the frame is complete, so the frame a crash interrupted
+// can still be read and recognized as such.
+struct FlightRecord {
+    uint32_t sequence = 0;      // frame number, from 1; 0 marks a never-written slot
+    uint32_t timeMillis = 0;    // since the recorder was opened
+    float frameSeconds = 0.0f;  // wall time of the previous frame as openFrameworks saw it
+    uint16_t creatures = 0;
+    uint16_t dormant = 0;
+    int32_t score = 0;
+    int16_t playerX = 0;        // player center, world units
+    int16_t playerY = 0;
+    uint8_t level = 0;
+    uint8_t lives = 0;
+    uint8_t power = 0;
+    uint8_t playerFlags = 0;    // FlightPlayerFlags
+    uint8_t quality = 0;        // PerformanceGovernor level
+    uint8_t events[FLIGHT_EVENT_COUNT] = {};
+    uint8_t inputMillis = 0;    // input-to-display latency of input this frame showed, saturates at 255
+    uint16_t zoneMicros[FLIGHT_ZONE_COUNT] = {}; // saturate at 65535
+    uint32_t allocations = 0;   // heap allocations during the frame
+    uint32_t commit = 0;
+
+    bool isComplete() const { return commit == sequence && sequence != 0; }
+};
+static_assert(sizeof(FlightRecord) == 64, "flight records are one cache line");
+
+// Keeps the last `capacity` frames in a ring of FlightRecords inside a memory-mapped
+// file. Recording is plain stores into shared pages, with no syscalls per frame;
+// the kernel owns the pages, so a crash or abort still leaves them in the file.
+// A frame slower than the stall threshold also saves a copy of the ring next to the
+// file, before later frames overwrite the lead-up. Decode either file offline with
+// ReadFlightRecording or `--flight <path>` (see main.cpp). POSIX only; open() fails
+// on Windows.
+class FlightRecorder {
+public:
+    static constexpr uint32_t MAGIC = 0x52465141; // "AQFR"
+    static constexpr uint16_t VERSION = 1;
+
+    FlightRecorder() = default;
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    bool open(const std::string& path, uint32_t capacity = 30 * 60); // 30 s at 60 fps
+    void close();
+    bool isOpen() const { return m_records != nullptr; }
+
+    // closes the previous frame and starts a new one; everything below fills the new one
+    FlightRecord* beginFrame(float frameSeconds);
+    FlightRecord* getCurrent() { return m_current; }
+    void addZone(FlightZone zone, double seconds);
+    void addEvent(FlightEvent event);
+
+    void setStallThreshold(float seconds) { m_stallSeconds = seconds; } // 0 turns stall copies off
+    bool saveCopy(const std::string& path) const;
+    const std::string& getPath() const { return m_path; }
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordSize;
+        uint32_t capacity;
+        uint32_t reserved;
+        uint64_t head;      // newest committed sequence
+        uint64_t startUnixMillis;
+        uint8_t padding[32];
+    };
+    static_assert(sizeof(Header) == 64, "the header fills one record slot");
+
+    void commit();
+
+    std::string m_path;
+    int m_fd = -1;
+    void* m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+    Header* m_header = nullptr;
+    FlightRecord* m_records = nullptr;
+    uint32_t m_capacity = 0;
+    uint32_t m_sequence = 0;
+    FlightRecord* m_current = nullptr;
+    uint64_t m_frameAllocations = 0; // counter value when the frame began
+    std::chrono::steady_clock::time_point m_start;
+    float m_stallSeconds = 0.25f;
+    uint32_t m_lastStallCopy = 0;
+};
+
+// Times one zone into the recorder's current frame; does nothing without a recorder.
+class FlightZoneTimer {
+public:
+    FlightZoneTimer(FlightRecorder* recorder, FlightZone zone) : m_recorder(recorder), m_zone(zone) {
+        if (m_recorder) m_start = std::chrono::steady_clock::now();
+    }
+    ~FlightZoneTimer() { stop(); }
+    void stop() { // ends the zone early
+        if (m_recorder) m_recorder->addZone(m_zone, std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count());
+        m_recorder = nullptr;
+    }
+    FlightZoneTimer(const FlightZoneTimer&) = delete;
+    FlightZoneTimer& operator=(const FlightZoneTimer&) = delete;
+
+private:
+    FlightRecorder* m_recorder;
+    FlightZone m_zone;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+const char* FlightZoneToString(FlightZone zone);
+const char* FlightEventToString(FlightEvent event);
+// oldest first; the last record may be incomplete if the writer died mid-frame
+bool ReadFlightRecording(const std::string& path, std::vector<FlightRecord>& records);
+// logs the newest `count` frames as a table, 0 for all of them
+bool LogFlightRecording(const std::string& path, size_t count = 0);
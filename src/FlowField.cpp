@@ -0,0 +1,104 @@
+#include "FlowField.h"
+
+
+// the grid only reallocates when its dimensions change, so sliding it along with the camera is free
+void FlowField::setRegion(int x, int y, int width, int height) {
+    m_originX = x;
+    m_originY = y;
+    int columns = std::max(1, (width + CELL_SIZE - 1) / CELL_SIZE);
+    int rows = std::max(1, (height + CELL_SIZE - 1) / CELL_SIZE);
+    if (columns == m_columns && rows == m_rows && !m_cells.empty()) return;
+    m_columns = columns;
+    m_rows = rows;
+    m_stride = m_columns + 2;
+    m_cells.assign(static_cast<size_t>(m_columns) * m_rows, FlowCell());
+    size_t padded = static_cast<size_t>(m_stride) * (m_rows + 2);
+    m_playerDistances.assign(padded, UINT16_MAX);
+    m_threatDistances.assign(padded, UINT16_MAX);
+}
+
+void FlowField::clear() {
+    std::fill(m_cells.begin(), m_cells.end(), FlowCell());
+}
+
+// Without obstacles, breadth-first distance on a 4-connected grid is the Manhattan
+// distance to the nearest source, which two raster sweeps compute exactly with no
+// queue and no index arithmetic. The one-cell border stays at UINT16_MAX.
+void FlowField::distanceTransform(std::vector<uint16_t>& distances) const {
+    for (int row = 0; row < m_rows; ++row) {
+        uint16_t* cell = &distances[paddedIndex(0, row)];
+        for (int column = 0; column < m_columns; ++column, ++cell) {
+            int best = std::min<int>(cell[-1], cell[-m_stride]) + 1;
+            if (best < *cell) *cell = static_cast<uint16_t>(best);
+        }
+    }
+    for (int row = m_rows - 1; row >= 0; --row) {
+        uint16_t* cell = &distances[paddedIndex(m_columns - 1, row)];
+        for (int column = m_columns - 1; column >= 0; --column, --cell) {
+            int best = std::min<int>(cell[1], cell[m_stride]) + 1;
+            if (best < *cell) *cell = static_cast<uint16_t>(best);
+        }
+    }
+}
+
+void FlowField::rebuild(const glm::vec2* players, int playerCount, bool playerIsPredator, const std::vector<Creature*>& predators) {
+    if (m_cells.empty()) return;
+    m_playerIsPredator = playerIsPredator;
+
+    std::fill(m_playerDistances.begin(), m_playerDistances.end(), UINT16_MAX);
+    std::fill(m_threatDistances.begin(), m_threatDistances.end(), UINT16_MAX);
+    int column, row;
+    for (int i = 0; i < playerCount; ++i) {
+        cellOf(players[i].x, players[i].y, column, row);
+        m_playerDistances[paddedIndex(column, row)] = 0;
+        m_threatDistances[paddedIndex(column, row)] = 0;
+    }
+    for (const Creature* predator : predators) {
+        cellOf(predator->getCenterX(), predator->getCenterY(), column, row);
+        m_threatDistances[paddedIndex(column, row)] = 0;
+    }
+    distanceTransform(m_playerDistances);
+    distanceTransform(m_threatDistances);
+    // off-grid neighbours must never win: the chase border is already unreachable,
+    // the flee border becomes as close to a threat as it gets
+    for (int c = -1; c <= m_columns; ++c) {
+        m_threatDistances[paddedIndex(c, -1)] = 0;
+        m_threatDistances[paddedIndex(c, m_rows)] = 0;
+    }
+    for (int r = 0; r < m_rows; ++r) {
+        m_threatDistances[paddedIndex(-1, r)] = 0;
+        m_threatDistances[paddedIndex(m_columns, r)] = 0;
+    }
+
+    // each cell points at its 8-neighbour that is closest to the player / farthest from threats;
+    // neighbours are visited row by row from the top-left, first strict improvement wins
+    const float diagonal = 0.70710678f;
+    const int offsets[8] = {-m_stride - 1, -m_stride, -m_stride + 1, -1, 1, m_stride - 1, m_stride, m_stride + 1};
+    const float directionX[8] = {-diagonal, 0.0f, diagonal, -1.0f, 1.0f, -diagonal, 0.0f, diagonal};
+    const float directionY[8] = {-diagonal, -1.0f, -diagonal, 0.0f, 0.0f, diagonal, 1.0f, diagonal};
+    for (int r = 0; r < m_rows; ++r) {
+        const uint16_t* player = &m_playerDistances[paddedIndex(0, r)];
+        const uint16_t* threat = &m_threatDistances[paddedIndex(0, r)];
+        FlowCell* cell = &m_cells[static_cast<size_t>(r) * m_columns];
+        for (int c = 0; c < m_columns; ++c, ++player, ++threat, ++cell) {
+            int bestChase = *player, bestFlee = *threat;
+            int chase = -1, flee = -1;
+            for (int k = 0; k < 8; ++k) {
+                if (player[offsets[k]] < bestChase) {
+                    bestChase = player[offsets[k]];
+                    chase = k;
+                }
+                if (threat[offsets[k]] > bestFlee) {
+                    bestFlee = threat[offsets[k]];
+                    flee = k;
+                }
+            }
+            cell->playerDistance = *player;
+            cell->threatDistance = *threat;
+            cell->chaseX = chase < 0 ? 0.0f : directionX[chase];
+            cell->chaseY = chase < 0 ? 0.0f : directionY[chase];
+            cell->fleeX = flee < 0 ? 0.0f : directionX[flee];
+            cell->fleeY = flee < 0 ? 0.0f : directionY[flee];
+        }
+    }
+}
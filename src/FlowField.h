@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Core.h"
+
+
+// One grid cell of the shared steering field. Directions are unit vectors (or zero)
+// toward the player and away from the nearest threat; distances are in cells.
+struct FlowCell {
+    float chaseX = 0.0f;
+    float chaseY = 0.0f;
+    float fleeX = 0.0f;
+    float fleeY = 0.0f;
+    uint16_t playerDistance = UINT16_MAX;
+    uint16_t threatDistance = UINT16_MAX;
+};
+
+// Grid flow/influence field rebuilt once per aquarium tick from the player and the
+// predators with two distance transforms, so steering costs O(cells + creatures)
+// per tick and every NPC samples its cell in O(1) instead of scanning targets.
+class FlowField {
+public:
+    static constexpr int CELL_SIZE = 48;
+
+    void resize(int width, int height) { setRegion(0, 0, width, height); }
+    // covers only this part of the world (the active chunks); outside it samples clamp to the edge
+    void setRegion(int x, int y, int width, int height);
+    // threats are the player plus every predator; predatorMode flips the player from prey to hunter
+    void rebuild(float playerX, float playerY, bool playerIsPredator, const std::vector<Creature*>& predators) {
+        glm::vec2 player(playerX, playerY);
+        rebuild(&player, 1, playerIsPredator, predators);
+    }
+    // several players: every one of them is a chase target and a threat
+    void rebuild(const glm::vec2* players, int playerCount, bool playerIsPredator, const std::vector<Creature*>& predators);
+    void clear();
+
+    // inline: every moving NPC samples once per tick
+    const FlowCell& sample(float x, float y) const {
+        if (m_cells.empty()) return m_empty;
+        return m_cells[cellIndex(x, y)];
+    }
+    bool isPlayerPredator() const { return m_playerIsPredator; }
+    int getColumns() const { return m_columns; }
+    int getRows() const { return m_rows; }
+
+private:
+    void cellOf(float x, float y, int& column, int& row) const {
+        column = std::min(m_columns - 1, std::max(0, (static_cast<int>(x) - m_originX) / CELL_SIZE));
+        row = std::min(m_rows - 1, std::max(0, (static_cast<int>(y) - m_originY) / CELL_SIZE));
+    }
+    int cellIndex(float x, float y) const {
+        int column, row;
+        cellOf(x, y, column, row);
+        return row * m_columns + column;
+    }
+    // distances are kept with a one-cell border so neighbour reads never need bounds checks
+    int paddedIndex(int column, int row) const { return (row + 1) * m_stride + column + 1; }
+    void distanceTransform(std::vector<uint16_t>& distances) const;
+
+    int m_originX = 0;
+    int m_originY = 0;
+    int m_columns = 0;
+    int m_rows = 0;
+    int m_stride = 0; // m_columns + 2
+    bool m_playerIsPredator = false;
+    std::vector<FlowCell> m_cells;
+    std::vector<uint16_t> m_playerDistances;
+    std::vector<uint16_t> m_threatDistances;
+    FlowCell m_empty;
+};
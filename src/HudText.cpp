@@ -0,0 +1,116 @@
+#include "HudText.h"
+#include "MemoryStats.h"
+
+
+HudTextLayer::~HudTextLayer() {
+    TrackGpuMemory(MemoryTag::SPRITES, -m_textureBytes);
+}
+
+bool HudTextLayer::load(const std::string& fontPath, int size) {
+    MemoryScope memory(MemoryTag::SPRITES);
+    m_loaded = m_font.load(fontPath, size, true, true);
+    if (!m_loaded) {
+        ofLogError() << "HudTextLayer: could not load " << fontPath << ", falling back to bitmap text";
+        return false;
+    }
+
+    // the middle of the 'I' stem is fully covered, so markers can sample the same atlas
+    const ofMesh& probe = m_font.getStringMesh("I", 0, 0);
+    const std::vector<glm::vec2>& texCoords = probe.getTexCoords();
+    for (const glm::vec2& uv : texCoords) {
+        m_solidTexel.x += uv.x / texCoords.size();
+        m_solidTexel.y += uv.y / texCoords.size();
+    }
+    TrackGpuMemory(MemoryTag::SPRITES, -m_textureBytes);
+    m_textureBytes = EstimateTextureBytes(m_font.getFontTexture().getWidth(), m_font.getFontTexture().getHeight(), false);
+    TrackGpuMemory(MemoryTag::SPRITES, m_textureBytes);
+    m_dirty = true;
+    return true;
+}
+
+void HudTextLayer::setLine(int index, const std::string& text, float x, float y, const ofColor& color) {
+    if (index >= static_cast<int>(m_lines.size())) {
+        m_lines.resize(index + 1);
+    }
+    Line& line = m_lines[index];
+    if (line.text == text && line.x == x && line.y == y && line.color == color) return;
+    line.text = text;
+    line.x = x;
+    line.y = y;
+    line.color = color;
+    m_dirty = true;
+}
+
+void HudTextLayer::setMarkers(int count, float x, float y, float spacing, float radius, const ofColor& color) {
+    if (count == m_markerCount && x == m_markerX && y == m_markerY && spacing == m_markerSpacing
+        && radius == m_markerRadius && color == m_markerColor) return;
+    m_markerCount = count;
+    m_markerX = x;
+    m_markerY = y;
+    m_markerSpacing = spacing;
+    m_markerRadius = radius;
+    m_markerColor = color;
+    m_dirty = true;
+}
+
+void HudTextLayer::addMarker(float cx, float cy) {
+    const int segments = 12;
+    ofIndexType center = m_mesh.getNumVertices();
+    m_mesh.addVertex(glm::vec3(cx, cy, 0));
+    for (int i = 0; i < segments; ++i) {
+        float angle = TWO_PI * i / segments;
+        m_mesh.addVertex(glm::vec3(cx + std::cos(angle) * m_markerRadius, cy + std::sin(angle) * m_markerRadius, 0));
+    }
+    for (int i = 0; i <= segments; ++i) {
+        m_mesh.addTexCoord(m_solidTexel);
+        m_mesh.addColor(m_markerColor);
+    }
+    for (int i = 0; i < segments; ++i) {
+        m_mesh.addIndex(center);
+        m_mesh.addIndex(center + 1 + i);
+        m_mesh.addIndex(center + 1 + (i + 1) % segments);
+    }
+}
+
+void HudTextLayer::rebuild() {
+    m_mesh.clear();
+    m_mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+    for (const Line& line : m_lines) {
+        if (line.text.empty()) continue;
+        size_t first = m_mesh.getNumVertices();
+        m_mesh.append(m_font.getStringMesh(line.text, line.x, line.y));
+        for (size_t i = first; i < m_mesh.getNumVertices(); ++i) {
+            m_mesh.addColor(line.color);
+        }
+    }
+    for (int i = 0; i < m_markerCount; ++i) {
+        addMarker(m_markerX + i * m_markerSpacing, m_markerY);
+    }
+    m_dirty = false;
+    ++m_rebuilds;
+}
+
+void HudTextLayer::draw() {
+    // no GPU font (headless, software frames): draw the same content immediate-mode
+    if (!m_loaded || GetSoftwareRenderTarget() != nullptr) {
+        for (const Line& line : m_lines) {
+            if (line.text.empty()) continue;
+            RenderSetColor(line.color);
+            RenderText(line.text, line.x, line.y);
+        }
+        RenderSetColor(m_markerColor);
+        for (int i = 0; i < m_markerCount; ++i) {
+            RenderCircle(m_markerX + i * m_markerSpacing, m_markerY, m_markerRadius);
+        }
+        RenderSetColor(ofColor::white);
+        return;
+    }
+
+    if (m_dirty) {
+        rebuild();
+    }
+    ofSetColor(ofColor::white);
+    m_font.getFontTexture().bind();
+    m_mesh.draw();
+    m_font.getFontTexture().unbind();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include "ofMain.h"
+#include "SoftwareRenderer.h"
+
+
+// Retained HUD text. Glyphs are rasterized once into the font's atlas at load time;
+// the combined mesh for every line and marker is rebuilt only when one of them
+// changes, and the whole HUD goes out as a single textured draw call.
+class HudTextLayer {
+public:
+    HudTextLayer() = default;
+    ~HudTextLayer();
+    HudTextLayer(const HudTextLayer&) = delete;
+    HudTextLayer& operator=(const HudTextLayer&) = delete;
+
+    bool load(const std::string& fontPath, int size);
+    bool isLoaded() const { return m_loaded; }
+
+    // no-ops (and no rebuild) when nothing about the line changed
+    void setLine(int index, const std::string& text, float x, float y, const ofColor& color);
+    // a row of filled dots, e.g. one per life
+    void setMarkers(int count, float x, float y, float spacing, float radius, const ofColor& color);
+    void draw();
+
+    unsigned long getRebuildCount() const { return m_rebuilds; }
+
+private:
+    struct Line {
+        std::string text;
+        float x = 0.0f;
+        float y = 0.0f;
+        ofColor color;
+    };
+
+    void rebuild();
+    void addMarker(float cx, float cy);
+
+    ofTrueTypeFont m_font;
+    bool m_loaded = false;
+    bool m_dirty = true;
+    std::vector<Line> m_lines;
+
+    int m_markerCount = 0;
+    float m_markerX = 0.0f;
+    float m_markerY = 0.0f;
+    float m_markerSpacing = 0.0f;
+    float m_markerRadius = 0.0f;
+    ofColor m_markerColor;
+
+    ofVboMesh m_mesh;
+    glm::vec2 m_solidTexel; // an opaque atlas texel so markers share the glyph texture
+    unsigned long m_rebuilds = 0;
+    int64_t m_textureBytes = 0; // glyph atlas, estimated
+};
@@ -0,0 +1,97 @@
+#include "InputQueue.h"
+#include "ofMain.h"
+
+
+// about one, two, three... frames at 60 fps, then the long tail
+const double InputLatencyStats::BUCKET_LIMITS[BUCKET_COUNT] = {0.008, 0.017, 0.033, 0.050, 0.067, 0.100, 0.200, 1e9};
+
+void InputLatencyStats::add(double seconds) {
+    ++samples;
+    totalSeconds += seconds;
+    maxSeconds = std::max(maxSeconds, seconds);
+    int bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && seconds >= BUCKET_LIMITS[bucket]) ++bucket;
+    ++histogram[bucket];
+}
+
+double InputLatencyStats::getPercentile(double fraction) const {
+    if (samples == 0) return 0.0;
+    unsigned long wanted = static_cast<unsigned long>(std::ceil(samples * fraction));
+    unsigned long seen = 0;
+    for (int bucket = 0; bucket < BUCKET_COUNT - 1; ++bucket) {
+        seen += histogram[bucket];
+        if (seen >= wanted) return BUCKET_LIMITS[bucket];
+    }
+    return maxSeconds;
+}
+
+bool InputQueue::MapKey(int key, InputAction& action) {
+    switch (key) {
+        case OF_KEY_UP: action = InputAction::UP; return true;
+        case OF_KEY_DOWN: action = InputAction::DOWN; return true;
+        case OF_KEY_LEFT: action = InputAction::LEFT; return true;
+        case OF_KEY_RIGHT: action = InputAction::RIGHT; return true;
+        default: return false;
+    }
+}
+
+bool InputQueue::push(int key, bool pressed) {
+    InputAction action;
+    if (!MapKey(key, action)) return false;
+    bool& down = m_down[static_cast<int>(action)];
+    if (down == pressed) return true; // key repeat, or a release we never saw pressed
+    down = pressed;
+    m_pending.push_back({action, pressed, Clock::now()});
+    return true;
+}
+
+void InputQueue::drain() {
+    m_tapped.fill(false);
+    if (m_pending.empty()) return;
+    if (!m_awaitingDisplay) {
+        m_oldestApplied = m_pending.front().time;
+        m_awaitingDisplay = true;
+    }
+    for (const Event& event : m_pending) {
+        int index = static_cast<int>(event.action);
+        m_held[index] = event.pressed;
+        if (event.pressed) {
+            m_pressOrder[index] = ++m_presses;
+            m_tapped[index] = true;
+        }
+    }
+    m_pending.clear();
+}
+
+void InputQueue::clear() {
+    m_pending.clear();
+    m_down.fill(false);
+    m_held.fill(false);
+    m_tapped.fill(false);
+    m_awaitingDisplay = false;
+}
+
+float InputQueue::axis(InputAction negative, InputAction positive) const {
+    bool back = isHeld(negative), forward = isHeld(positive);
+    if (back && forward) {
+        return m_pressOrder[static_cast<int>(negative)] > m_pressOrder[static_cast<int>(positive)] ? -1.0f : 1.0f;
+    }
+    return back ? -1.0f : forward ? 1.0f : 0.0f;
+}
+
+double InputQueue::markDisplayed() {
+    if (!m_awaitingDisplay) return -1.0;
+    m_awaitingDisplay = false;
+    double seconds = std::chrono::duration<double>(Clock::now() - m_oldestApplied).count();
+    m_latency.add(seconds);
+    return seconds;
+}
+
+void LogInputLatency(const InputLatencyStats& latency) {
+    if (latency.samples == 0) {
+        ofLogNotice("input") << "no input latency samples";
+        return;
+    }
+    ofLogNotice("input") << "input to display over " << latency.samples << " inputs: mean " << latency.getMean() * 1000.0
+        << "ms, p95 under " << latency.getPercentile(0.95) * 1000.0 << "ms, max " << latency.maxSeconds * 1000.0 << "ms";
+}
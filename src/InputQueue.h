@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+
+enum class InputAction : uint8_t {
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT,
+    COUNT
+};
+constexpr int INPUT_ACTION_COUNT = static_cast<int>(InputAction::COUNT);
+
+// Time from a key event to the end of the Draw that first showed its effect (the buffer
+// swap follows, so the real figure is up to one refresh longer).
+struct InputLatencyStats {
+    static constexpr int BUCKET_COUNT = 8;
+    static const double BUCKET_LIMITS[BUCKET_COUNT]; // upper bounds in seconds, the last is open
+
+    unsigned long samples = 0;
+    double totalSeconds = 0.0;
+    double maxSeconds = 0.0;
+    std::array<unsigned long, BUCKET_COUNT> histogram{};
+
+    void add(double seconds);
+    double getMean() const { return samples ? totalSeconds / samples : 0.0; }
+    double getPercentile(double fraction) const; // the bucket's upper bound, so an overestimate
+};
+
+// Key events from the window callbacks, stamped on arrival and applied in order once at
+// the start of each simulation tick. The game reads which keys are held rather than
+// reacting to each press, so movement only happens inside the tick and OS key repeat
+// changes nothing. Callbacks and ticks both run on the main thread.
+class InputQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static bool MapKey(int key, InputAction& action); // arrow keys
+    bool push(int key, bool pressed); // false for keys that are not game input
+    void drain();
+    void clear(); // everything released, nothing pending
+
+    bool isHeld(InputAction action) const { return m_held[static_cast<int>(action)] || m_tapped[static_cast<int>(action)]; }
+    // -1, 0 or 1; with both opposites held the later press wins
+    float getDx() const { return axis(InputAction::LEFT, InputAction::RIGHT); }
+    float getDy() const { return axis(InputAction::UP, InputAction::DOWN); }
+
+    // after the Draw following a drain; the latency of the oldest event that drain applied,
+    // in seconds, or a negative value when it applied none
+    double markDisplayed();
+    const InputLatencyStats& getLatency() const { return m_latency; }
+
+private:
+    struct Event {
+        InputAction action;
+        bool pressed;
+        Clock::time_point time;
+    };
+
+    float axis(InputAction negative, InputAction positive) const;
+
+    std::vector<Event> m_pending;
+    std::array<bool, INPUT_ACTION_COUNT> m_down{}; // as events arrive, to drop key repeats
+    std::array<bool, INPUT_ACTION_COUNT> m_held{}; // as of the last drain
+    std::array<bool, INPUT_ACTION_COUNT> m_tapped{}; // pressed during the last drain, so a tap still moves one tick
+    std::array<uint32_t, INPUT_ACTION_COUNT> m_pressOrder{};
+    uint32_t m_presses = 0;
+    bool m_awaitingDisplay = false;
+    Clock::time_point m_oldestApplied;
+    InputLatencyStats m_latency;
+};
+
+void LogInputLatency(const InputLatencyStats& latency);
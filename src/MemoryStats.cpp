@@ -0,0 +1,192 @@
+#include "MemoryStats.h"
+#include "ofMain.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/resource.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#endif
+
+
+// relaxed: the counters are statistics, nothing is ordered by them
+struct TagCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<int64_t> heapBytes{0};
+    std::atomic<int64_t> heapPeak{0};
+    std::atomic<int64_t> gpuBytes{0};
+    std::atomic<int64_t> gpuPeak{0};
+};
+static TagCounters g_tags[MEMORY_TAG_COUNT];
+static std::atomic<uint64_t> g_bytesAllocated{0};
+static thread_local MemoryTag t_currentTag = MemoryTag::UNTAGGED;
+
+// in front of every block; 16 bytes keeps malloc's alignment for what follows
+struct alignas(16) BlockHeader {
+    uint64_t size;
+    MemoryTag tag;
+};
+static_assert(sizeof(BlockHeader) == 16, "block header must preserve alignment");
+
+static void raisePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+static void* countedAllocate(size_t size) {
+    void* memory = std::malloc(sizeof(BlockHeader) + size);
+    if (!memory) throw std::bad_alloc();
+    BlockHeader* header = static_cast<BlockHeader*>(memory);
+    header->size = size;
+    header->tag = t_currentTag;
+    TagCounters& tag = g_tags[static_cast<int>(header->tag)];
+    tag.allocations.fetch_add(1, std::memory_order_relaxed);
+    raisePeak(tag.heapPeak, tag.heapBytes.fetch_add(size, std::memory_order_relaxed) + static_cast<int64_t>(size));
+    g_bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    return header + 1;
+}
+
+static void countedFree(void* memory) {
+    if (!memory) return;
+    BlockHeader* header = static_cast<BlockHeader*>(memory) - 1;
+    TagCounters& tag = g_tags[static_cast<int>(header->tag)];
+    tag.frees.fetch_add(1, std::memory_order_relaxed);
+    tag.heapBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(header);
+}
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return countedAllocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return countedAllocate(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* memory) noexcept { countedFree(memory); }
+void operator delete[](void* memory) noexcept { countedFree(memory); }
+void operator delete(void* memory, size_t) noexcept { countedFree(memory); }
+void operator delete[](void* memory, size_t) noexcept { countedFree(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { countedFree(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { countedFree(memory); }
+
+const char* MemoryTagToString(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::UNTAGGED: return "untagged";
+        case MemoryTag::SPRITES: return "sprites";
+        case MemoryTag::CREATURES: return "creatures";
+        case MemoryTag::EVENTS: return "events";
+        case MemoryTag::LEVELS: return "levels";
+        case MemoryTag::AUDIO: return "audio";
+        default: return "unknown";
+    }
+}
+
+MemoryScope::MemoryScope(MemoryTag tag) : m_previous(t_currentTag) {
+    t_currentTag = tag;
+}
+
+MemoryScope::~MemoryScope() {
+    t_currentTag = m_previous;
+}
+
+void TrackGpuMemory(MemoryTag tag, int64_t bytes) {
+    TagCounters& counters = g_tags[static_cast<int>(tag)];
+    raisePeak(counters.gpuPeak, counters.gpuBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+int64_t EstimateTextureBytes(int width, int height, bool mipmaps) {
+    int64_t bytes = static_cast<int64_t>(width) * height * 4;
+    return mipmaps ? bytes + bytes / 3 : bytes;
+}
+
+MemoryTagStats GetMemoryTagStats(MemoryTag tag) {
+    const TagCounters& counters = g_tags[static_cast<int>(tag)];
+    MemoryTagStats stats;
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.frees = counters.frees.load(std::memory_order_relaxed);
+    stats.heapBytes = counters.heapBytes.load(std::memory_order_relaxed);
+    stats.heapPeak = counters.heapPeak.load(std::memory_order_relaxed);
+    stats.gpuBytes = counters.gpuBytes.load(std::memory_order_relaxed);
+    stats.gpuPeak = counters.gpuPeak.load(std::memory_order_relaxed);
+    return stats;
+}
+
+static std::string formatBytes(int64_t bytes) {
+    char text[32];
+    if (bytes >= 10 * 1024 * 1024 || bytes <= -10 * 1024 * 1024) std::snprintf(text, sizeof(text), "%.1fMB", bytes / (1024.0 * 1024.0));
+    else std::snprintf(text, sizeof(text), "%.1fKB", bytes / 1024.0);
+    return text;
+}
+
+std::string DescribeMemoryTag(MemoryTag tag) {
+    MemoryTagStats stats = GetMemoryTagStats(tag);
+    std::string line = std::string(MemoryTagToString(tag)) + ": " + formatBytes(stats.heapBytes)
+        + " in " + std::to_string(stats.getLiveBlocks()) + " blocks";
+    if (stats.gpuPeak > 0) line += ", gpu " + formatBytes(stats.gpuBytes);
+    return line;
+}
+
+void LogMemoryReport() {
+    ofLogNotice("memory") << "tag        heap now   heap peak   blocks    allocs   gpu now   gpu peak";
+    for (int i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        MemoryTag tag = static_cast<MemoryTag>(i);
+        MemoryTagStats stats = GetMemoryTagStats(tag);
+        char row[160];
+        std::snprintf(row, sizeof(row), "%-9s %10s %11s %8llu %9llu %9s %10s", MemoryTagToString(tag),
+            formatBytes(stats.heapBytes).c_str(), formatBytes(stats.heapPeak).c_str(),
+            static_cast<unsigned long long>(stats.getLiveBlocks()), static_cast<unsigned long long>(stats.allocations),
+            formatBytes(stats.gpuBytes).c_str(), formatBytes(stats.gpuPeak).c_str());
+        ofLogNotice("memory") << row;
+    }
+    ofLogNotice("memory") << "rss " << formatBytes(GetResidentBytes()) << ", peak " << formatBytes(GetPeakResidentBytes());
+}
+
+AllocationCounters GetAllocationCounters() {
+    AllocationCounters counters;
+    for (const TagCounters& tag : g_tags) {
+        counters.allocations += tag.allocations.load(std::memory_order_relaxed);
+        counters.frees += tag.frees.load(std::memory_order_relaxed);
+        counters.liveBytes += tag.heapBytes.load(std::memory_order_relaxed);
+    }
+    counters.bytesAllocated = g_bytesAllocated.load(std::memory_order_relaxed);
+    return counters;
+}
+
+size_t GetResidentBytes() {
+#if defined(__linux__)
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) return 0;
+    unsigned long pages = 0, resident = 0;
+    int read = std::fscanf(file, "%lu %lu", &pages, &resident);
+    std::fclose(file);
+    return read == 2 ? resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) return 0;
+    return info.resident_size;
+#else
+    return 0;
+#endif
+}
+
+size_t GetPeakResidentBytes() {
+#if defined(__linux__) || defined(__APPLE__)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return usage.ru_maxrss; // bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes on Linux
+#endif
+#else
+    return 0;
+#endif
+}
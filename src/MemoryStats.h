@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+// Subsystems heap memory is charged to. Allocations made inside a MemoryScope go to
+// its tag, everything else to UNTAGGED; a block is credited back to the tag it was
+// charged to whichever thread frees it.
+enum class MemoryTag : uint8_t {
+    UNTAGGED,
+    SPRITES,   // pixels, textures, fonts
+    CREATURES, // creatures, their buckets and dormant records
+    EVENTS,    // GameEvents
+    LEVELS,    // level tables and their population nodes
+    AUDIO,     // decoded effects and stream buffers
+    COUNT
+};
+constexpr int MEMORY_TAG_COUNT = static_cast<int>(MemoryTag::COUNT);
+const char* MemoryTagToString(MemoryTag tag);
+
+// Charges heap allocations on this thread to `tag` until it goes out of scope. Scopes
+// nest; the innermost wins, so a sprite loaded while spawning a creature is a sprite.
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryTag tag);
+    ~MemoryScope();
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTag m_previous;
+};
+
+// GPU memory never passes through operator new, so uploads report their estimated
+// size here (negative when released).
+void TrackGpuMemory(MemoryTag tag, int64_t bytes);
+// bytes of an RGBA8 texture, a third more with mipmaps
+int64_t EstimateTextureBytes(int width, int height, bool mipmaps);
+
+struct MemoryTagStats {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    int64_t heapBytes = 0;
+    int64_t heapPeak = 0; // high-water marks since start
+    int64_t gpuBytes = 0;
+    int64_t gpuPeak = 0;
+
+    uint64_t getLiveBlocks() const { return allocations - frees; }
+};
+
+MemoryTagStats GetMemoryTagStats(MemoryTag tag);
+std::string DescribeMemoryTag(MemoryTag tag); // one HUD line
+void LogMemoryReport(); // every tag with its high-water marks
+
+// Process-wide heap counters, kept by the replacement global operator new/delete in
+// MemoryStats.cpp. Every block carries a small header with its size and tag; the
+// memory itself still comes from malloc.
+struct AllocationCounters {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytesAllocated = 0; // cumulative, frees do not subtract
+    int64_t liveBytes = 0;
+
+    uint64_t getLive() const { return allocations - frees; }
+};
+
+AllocationCounters GetAllocationCounters();
+
+// Resident set size of this process in bytes, 0 where the platform has no cheap way
+// to ask. The peak is the high-water mark since start.
+size_t GetResidentBytes();
+size_t GetPeakResidentBytes();
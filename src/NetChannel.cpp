@@ -0,0 +1,136 @@
+#include "NetChannel.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+std::string NetAddress::toString() const {
+    return std::to_string(host >> 24) + "." + std::to_string((host >> 16) & 0xFF) + "."
+        + std::to_string((host >> 8) & 0xFF) + "." + std::to_string(host & 0xFF) + ":" + std::to_string(port);
+}
+
+// UdpChannel Implementation
+UdpChannel::~UdpChannel() {
+    close();
+}
+
+#ifndef _WIN32
+bool UdpChannel::open(uint16_t port, uint32_t host) {
+    close();
+    m_socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_socket < 0) return false;
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(host);
+    address.sin_port = htons(port);
+    if (::bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::fcntl(m_socket, F_SETFL, ::fcntl(m_socket, F_GETFL, 0) | O_NONBLOCK) != 0) {
+        close();
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    ::getsockname(m_socket, reinterpret_cast<sockaddr*>(&address), &length);
+    m_address = NetAddress{ntohl(address.sin_addr.s_addr), ntohs(address.sin_port)};
+    return true;
+}
+
+void UdpChannel::close() {
+    if (m_socket >= 0) ::close(m_socket);
+    m_socket = -1;
+}
+
+bool UdpChannel::send(const NetAddress& to, const uint8_t* data, size_t size) {
+    if (m_socket < 0) return false;
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(to.host);
+    address.sin_port = htons(to.port);
+    if (::sendto(m_socket, data, size, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != static_cast<ssize_t>(size)) return false;
+    ++m_stats.packetsSent;
+    m_stats.bytesSent += size;
+    return true;
+}
+
+bool UdpChannel::receive(NetAddress& from, std::vector<uint8_t>& data) {
+    if (m_socket < 0) return false;
+    data.resize(65536); // the largest UDP payload; full snapshots of a busy tank can pass one MTU
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    ssize_t received = ::recvfrom(m_socket, data.data(), data.size(), 0, reinterpret_cast<sockaddr*>(&address), &length);
+    if (received < 0) return false;
+    data.resize(received);
+    from = NetAddress{ntohl(address.sin_addr.s_addr), ntohs(address.sin_port)};
+    ++m_stats.packetsReceived;
+    m_stats.bytesReceived += received;
+    return true;
+}
+#else
+bool UdpChannel::open(uint16_t /*port*/, uint32_t /*host*/) { return false; }
+void UdpChannel::close() {}
+bool UdpChannel::send(const NetAddress& /*to*/, const uint8_t* /*data*/, size_t /*size*/) { return false; }
+bool UdpChannel::receive(NetAddress& /*from*/, std::vector<uint8_t>& /*data*/) { return false; }
+#endif
+
+// LoopbackNetwork Implementation
+std::shared_ptr<LoopbackChannel> LoopbackNetwork::open(uint16_t port) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (port == 0) {
+        while (m_queues.count(m_nextPort)) ++m_nextPort;
+        port = m_nextPort++;
+    }
+    if (m_queues.count(port)) return nullptr; // already taken
+    m_queues[port];
+    return std::make_shared<LoopbackChannel>(shared_from_this(), port);
+}
+
+void LoopbackNetwork::setLoss(float probability, unsigned int seed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loss = probability;
+    m_rng.seed(seed);
+}
+
+bool LoopbackNetwork::deliver(const NetAddress& from, const NetAddress& to, const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto queue = m_queues.find(to.port);
+    if (queue == m_queues.end()) return true; // like UDP, sending into the void succeeds
+    if (m_loss > 0.0f && std::uniform_real_distribution<float>(0.0f, 1.0f)(m_rng) < m_loss) return true;
+    queue->second.push_back(Datagram{from, std::vector<uint8_t>(data, data + size)});
+    return true;
+}
+
+void LoopbackNetwork::close(uint16_t port) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queues.erase(port);
+}
+
+// LoopbackChannel Implementation
+LoopbackChannel::LoopbackChannel(std::shared_ptr<LoopbackNetwork> network, uint16_t port)
+    : m_network(std::move(network)), m_port(port) {}
+
+LoopbackChannel::~LoopbackChannel() {
+    m_network->close(m_port);
+}
+
+bool LoopbackChannel::send(const NetAddress& to, const uint8_t* data, size_t size) {
+    if (!m_network->deliver(getAddress(), to, data, size)) return false;
+    ++m_stats.packetsSent;
+    m_stats.bytesSent += size;
+    return true;
+}
+
+bool LoopbackChannel::receive(NetAddress& from, std::vector<uint8_t>& data) {
+    std::lock_guard<std::mutex> lock(m_network->m_mutex);
+    auto queue = m_network->m_queues.find(m_port);
+    if (queue == m_network->m_queues.end() || queue->second.empty()) return false;
+    from = queue->second.front().from;
+    data.swap(queue->second.front().data);
+    queue->second.pop_front();
+    ++m_stats.packetsReceived;
+    m_stats.bytesReceived += data.size();
+    return true;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+
+// IPv4 address and port in host byte order. Loopback channels only use the port.
+struct NetAddress {
+    uint32_t host = 0;
+    uint16_t port = 0;
+
+    static NetAddress loopback(uint16_t port) { return NetAddress{0x7F000001u, port}; }
+    static NetAddress any(uint16_t port) { return NetAddress{0, port}; } // every interface, for binding
+    bool operator==(const NetAddress& other) const { return host == other.host && port == other.port; }
+    bool operator!=(const NetAddress& other) const { return !(*this == other); }
+    std::string toString() const;
+};
+
+// traffic counters, kept per channel and per server-side client
+struct NetStats {
+    unsigned long packetsSent = 0;
+    unsigned long packetsReceived = 0;
+    unsigned long bytesSent = 0;
+    unsigned long bytesReceived = 0;
+};
+
+// Unreliable, unordered datagrams. Both calls are non-blocking.
+class DatagramChannel {
+public:
+    virtual ~DatagramChannel() = default;
+    virtual bool send(const NetAddress& to, const uint8_t* data, size_t size) = 0;
+    // false when nothing is waiting
+    virtual bool receive(NetAddress& from, std::vector<uint8_t>& data) = 0;
+    virtual NetAddress getAddress() const = 0;
+    const NetStats& getStats() const { return m_stats; }
+
+protected:
+    NetStats m_stats;
+};
+
+// Real UDP, bound to 127.0.0.1 unless another address is given; NetAddress::any serves
+// every interface. Not available on Windows yet; open() fails there.
+class UdpChannel : public DatagramChannel {
+public:
+    ~UdpChannel();
+    bool open(uint16_t port, uint32_t host = NetAddress::loopback(0).host); // port 0 picks a free port
+    void close();
+    bool send(const NetAddress& to, const uint8_t* data, size_t size) override;
+    bool receive(NetAddress& from, std::vector<uint8_t>& data) override;
+    NetAddress getAddress() const override { return m_address; }
+
+private:
+    int m_socket = -1;
+    NetAddress m_address;
+};
+
+class LoopbackChannel;
+
+// In-process stand-in for the network, for tests and load runs: channels opened on the
+// same network deliver to each other's queues. Loss can be simulated to exercise
+// prediction and reconciliation.
+class LoopbackNetwork : public std::enable_shared_from_this<LoopbackNetwork> {
+public:
+    std::shared_ptr<LoopbackChannel> open(uint16_t port); // 0 picks a free port
+    void setLoss(float probability, unsigned int seed = 1);
+
+private:
+    friend class LoopbackChannel;
+    bool deliver(const NetAddress& from, const NetAddress& to, const uint8_t* data, size_t size);
+    void close(uint16_t port);
+
+    struct Datagram {
+        NetAddress from;
+        std::vector<uint8_t> data;
+    };
+    std::mutex m_mutex;
+    std::unordered_map<uint16_t, std::deque<Datagram>> m_queues;
+    uint16_t m_nextPort = 40000;
+    float m_loss = 0.0f;
+    std::mt19937 m_rng;
+};
+
+class LoopbackChannel : public DatagramChannel {
+public:
+    LoopbackChannel(std::shared_ptr<LoopbackNetwork> network, uint16_t port);
+    ~LoopbackChannel();
+    bool send(const NetAddress& to, const uint8_t* data, size_t size) override;
+    bool receive(NetAddress& from, std::vector<uint8_t>& data) override;
+    NetAddress getAddress() const override { return NetAddress::loopback(m_port); }
+
+private:
+    std::shared_ptr<LoopbackNetwork> m_network;
+    uint16_t m_port;
+};
+
+// Little-endian packet writer with LEB128 varints; zigzag keeps small negative deltas small.
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : m_out(out) {}
+    void u8(uint8_t value) { m_out.push_back(value); }
+    void u16(uint16_t value) { u8(value & 0xFF); u8(value >> 8); }
+    void u32(uint32_t value) { u16(value & 0xFFFF); u16(value >> 16); }
+    void varint(uint32_t value) {
+        while (value >= 0x80) {
+            u8(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        u8(static_cast<uint8_t>(value));
+    }
+    void zigzag(int32_t value) { varint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31)); }
+    size_t size() const { return m_out.size(); }
+
+private:
+    std::vector<uint8_t>& m_out;
+};
+
+// Reads what ByteWriter wrote. Running off the end sets !ok() and returns zeros, so a
+// truncated or hostile packet can be dropped after parsing instead of checked per field.
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : m_data(data), m_end(data + size) {}
+    uint8_t u8() {
+        if (m_data >= m_end) { m_ok = false; return 0; }
+        return *m_data++;
+    }
+    uint16_t u16() { uint16_t low = u8(); return low | static_cast<uint16_t>(u8() << 8); }
+    uint32_t u32() { uint32_t low = u16(); return low | (static_cast<uint32_t>(u16()) << 16); }
+    uint32_t varint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = u8();
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        m_ok = false;
+        return 0;
+    }
+    int32_t zigzag() { uint32_t value = varint(); return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1); }
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_data == m_end; }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+    bool m_ok = true;
+};
@@ -0,0 +1,58 @@
+#include "PerformanceGovernor.h"
+
+
+const std::array<GovernorLevel, 4> PerformanceGovernor::LEVELS = {{
+    {"Full", 1.0f, 8, 4, true},
+    {"Reduced", 0.75f, 6, 4, true},
+    {"Low", 0.5f, 4, 6, true},
+    {"Minimal", 0.35f, 0, 8, false},
+}};
+
+PerformanceGovernor::PerformanceGovernor(float targetFrameSeconds)
+    : m_target(targetFrameSeconds) {}
+
+void PerformanceGovernor::sampleFrame(float workSeconds) {
+    m_averageFrame = m_averageFrame == 0.0f ? workSeconds : m_averageFrame + (workSeconds - m_averageFrame) * SMOOTHING;
+}
+
+void PerformanceGovernor::sampleTick(float tickSeconds) {
+    m_averageTick = m_averageTick == 0.0f ? tickSeconds : m_averageTick + (tickSeconds - m_averageTick) * SMOOTHING;
+}
+
+bool PerformanceGovernor::evaluate() {
+    if (m_cooldown > 0) {
+        --m_cooldown;
+        return false;
+    }
+
+    // a tick only runs every few frames but must still fit in a single frame
+    float load = std::max(m_averageFrame, m_averageTick);
+    m_pressureFrames = load > m_target * PRESSURE_RATIO ? m_pressureFrames + 1 : 0;
+    m_headroomFrames = load < m_target * HEADROOM_RATIO ? m_headroomFrames + 1 : 0;
+
+    if (m_pressureFrames >= PRESSURE_FRAMES && m_level + 1 < getLevelCount()) {
+        changeLevel(m_level + 1, "over budget");
+        return true;
+    }
+    if (m_headroomFrames >= HEADROOM_FRAMES && m_level > 0) {
+        changeLevel(m_level - 1, "headroom");
+        return true;
+    }
+    return false;
+}
+
+void PerformanceGovernor::changeLevel(int level, const string& reason) {
+    int previous = m_level;
+    m_level = level;
+    m_pressureFrames = 0;
+    m_headroomFrames = 0;
+    m_cooldown = COOLDOWN_FRAMES;
+    m_lastDecision = LEVELS[previous].name + " -> " + LEVELS[level].name + " (" + reason + ")";
+    ofLogNotice() << "PerformanceGovernor: " << m_lastDecision
+        << ", frame " << m_averageFrame * 1000.0f << "ms, tick " << m_averageTick * 1000.0f
+        << "ms, budget " << m_target * 1000.0f << "ms";
+}
+
+string PerformanceGovernor::describe() const {
+    return "Quality: " + LEVELS[m_level].name + " (" + std::to_string(m_level + 1) + "/" + std::to_string(getLevelCount()) + ")";
+}
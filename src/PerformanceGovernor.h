@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include "ofMain.h"
+
+
+// What the game runs at for one governor step. Step 0 is full quality.
+struct GovernorLevel {
+    string name;
+    float populationScale;  // fraction of the level's population allowed in the tank
+    int schoolingNeighbors; // boids neighbor cap, 0 turns schooling off
+    int lodInterval;        // ticks between moves for creatures far from the player
+    bool drawBackground;    // full-screen background image
+};
+
+// Watches moving-average frame work and simulation tick times against a frame
+// budget. Sustained pressure steps quality down, sustained headroom steps it back
+// up; the two thresholds are far apart and every change starts a cooldown, so it
+// settles instead of oscillating.
+class PerformanceGovernor {
+public:
+    explicit PerformanceGovernor(float targetFrameSeconds = 1.0f / 60.0f);
+
+    void sampleFrame(float workSeconds); // CPU time spent on update + draw
+    void sampleTick(float tickSeconds);  // CPU time of one simulation tick
+    bool evaluate();                     // once per frame; true when the level changed
+
+    int getLevel() const { return m_level; }
+    int getLevelCount() const { return static_cast<int>(LEVELS.size()); }
+    const GovernorLevel& getSettings() const { return LEVELS[m_level]; }
+    float getAverageFrame() const { return m_averageFrame; }
+    float getAverageTick() const { return m_averageTick; }
+    const string& getLastDecision() const { return m_lastDecision; }
+    string describe() const;
+
+private:
+    static const std::array<GovernorLevel, 4> LEVELS;
+    static constexpr float SMOOTHING = 0.05f;       // EMA weight of a new sample
+    static constexpr float PRESSURE_RATIO = 0.85f;  // step down above this share of the budget
+    static constexpr float HEADROOM_RATIO = 0.45f;  // step up below this share
+    static constexpr int PRESSURE_FRAMES = 30;
+    static constexpr int HEADROOM_FRAMES = 240;
+    static constexpr int COOLDOWN_FRAMES = 120;
+
+    void changeLevel(int level, const string& reason);
+
+    float m_target;
+    float m_averageFrame = 0.0f;
+    float m_averageTick = 0.0f;
+    int m_level = 0;
+    int m_pressureFrames = 0;
+    int m_headroomFrames = 0;
+    int m_cooldown = 0;
+    string m_lastDecision;
+};
@@ -0,0 +1,133 @@
+#include "Powerup.h"
+#include <cmath>
+
+
+string PowerUpTypeToString(PowerUpType t){
+    switch(t){
+        case PowerUpType::SPEED:
+            return "Speed";
+        case PowerUpType::SIZE:
+            return "Size";
+        default:
+            return "UknownPowerUp";
+    }
+}
+
+// PowerUpField Implementation
+PowerUpField::PowerUpField(int capacity) {
+    m_powerUps.reserve(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        m_powerUps.emplace_back(0.0f, 0.0f, PowerUpType::SPEED, nullptr);
+    }
+    m_slots.resize(capacity);
+    m_free.reserve(capacity);
+    for (int i = capacity - 1; i >= 0; --i) {
+        m_free.push_back(i);
+    }
+    m_collected.reserve(capacity);
+    m_tints.fill(ofColor(255, 255, 255));
+    resize(1024, 768);
+}
+
+PowerUpField::~PowerUpField() {
+    clear(); // expiry callbacks point back into the pool
+}
+
+void PowerUpField::setSprite(PowerUpType type, std::shared_ptr<GameSprite> sprite, const ofColor& tint) {
+    m_sprites[static_cast<int>(type)] = std::move(sprite);
+    m_tints[static_cast<int>(type)] = tint;
+}
+
+void PowerUpField::resize(int width, int height) {
+    clear(); // positions from the old layout may not map to a cell any more
+    m_columns = std::max(1, static_cast<int>(std::ceil(width / CELL_SIZE)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(height / CELL_SIZE)));
+    m_cellHeads.assign(m_columns * m_rows, NONE);
+}
+
+int PowerUpField::cellOf(float x, float y) const {
+    int column = std::max(0, std::min(m_columns - 1, static_cast<int>(x / CELL_SIZE)));
+    int row = std::max(0, std::min(m_rows - 1, static_cast<int>(y / CELL_SIZE)));
+    return row * m_columns + column;
+}
+
+bool PowerUpField::spawn(float x, float y, PowerUpType type, float lifetimeSeconds) {
+    if (m_free.empty()) return false;
+    int index = m_free.back();
+    m_free.pop_back();
+
+    PowerUp& powerUp = m_powerUps[index];
+    powerUp.respawn(x, y, type, m_sprites[static_cast<int>(type)], m_tints[static_cast<int>(type)]);
+    Slot& slot = m_slots[index];
+    slot.active = true;
+    slot.cell = cellOf(powerUp.getCenterX(), powerUp.getCenterY());
+    slot.prev = NONE;
+    slot.next = m_cellHeads[slot.cell];
+    if (slot.next != NONE) m_slots[slot.next].prev = index;
+    m_cellHeads[slot.cell] = index;
+    if (m_timers) {
+        slot.expiry = m_timers->schedule(lifetimeSeconds, [this, index]() {
+            m_slots[index].expiry = TimerId();
+            release(index);
+        });
+    }
+    ++m_activeCount;
+    return true;
+}
+
+void PowerUpField::release(int index) {
+    Slot& slot = m_slots[index];
+    if (!slot.active) return;
+    if (m_timers) m_timers->cancel(slot.expiry);
+    if (slot.prev != NONE) {
+        m_slots[slot.prev].next = slot.next;
+    } else {
+        m_cellHeads[slot.cell] = slot.next;
+    }
+    if (slot.next != NONE) m_slots[slot.next].prev = slot.prev;
+    slot = Slot();
+    m_free.push_back(index);
+    --m_activeCount;
+}
+
+const std::vector<PowerUpType>& PowerUpField::collect(const Creature& collector) {
+    m_collected.clear();
+    if (m_activeCount == 0) return m_collected;
+
+    float r = collector.getCollisionRadius();
+    float cx = collector.getCenterX(), cy = collector.getCenterY();
+    float reach = r + m_powerUps.front().getCollisionRadius(); // every center that can overlap
+    int c0 = cellOf(cx - reach, cy - reach), c1 = cellOf(cx + reach, cy + reach);
+    int col0 = c0 % m_columns, row0 = c0 / m_columns;
+    int col1 = c1 % m_columns, row1 = c1 / m_columns;
+    for (int row = row0; row <= row1; ++row) {
+        for (int column = col0; column <= col1; ++column) {
+            int index = m_cellHeads[row * m_columns + column];
+            while (index != NONE) {
+                int next = m_slots[index].next;
+                const PowerUp& powerUp = m_powerUps[index];
+                float pr = powerUp.getCollisionRadius();
+                float dx = powerUp.getCenterX() - cx;
+                float dy = powerUp.getCenterY() - cy;
+                if (dx * dx + dy * dy <= (r + pr) * (r + pr)) {
+                    m_collected.push_back(powerUp.getType());
+                    release(index);
+                }
+                index = next;
+            }
+        }
+    }
+    return m_collected;
+}
+
+void PowerUpField::clear() {
+    for (int i = 0; i < static_cast<int>(m_slots.size()); ++i) {
+        release(i);
+    }
+}
+
+void PowerUpField::draw() const {
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        if (m_slots[i].active) m_powerUps[i].draw();
+    }
+}
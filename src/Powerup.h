@@ -1,11 +1,18 @@
 #pragma once
+#include <array>
+#include <vector>
 #include "Core.h"
+#include "TimerWheel.h"
 
 enum class PowerUpType {
     SPEED,
     SIZE
 };
 
+constexpr int POWER_UP_TYPE_COUNT = 2;
+
+string PowerUpTypeToString(PowerUpType t);
+
 class PowerUp : public Creature {
 public:
     PowerUp(float x, float y, PowerUpType type, std::shared_ptr<GameSprite> sprite)
@@ -14,7 +21,7 @@ public:
     void move() override {} // Power-up stays in place (or could float later)
 
     void draw() const override {
-        if (m_sprite) m_sprite->draw(m_x, m_y);
+        if (m_sprite) m_sprite->draw(m_x, m_y, m_renderState);
     }
 
     PowerUpType getType() const { return m_type; }
@@ -23,6 +30,69 @@ public:
         // Optional: add floating animation or effects here
     }
 
+    // pooled power-ups are recycled in place instead of reallocated
+    void respawn(float x, float y, PowerUpType type, const std::shared_ptr<GameSprite>& sprite, const ofColor& tint) {
+        m_x = m_prevX = x;
+        m_y = m_prevY = y;
+        m_type = type;
+        if (m_sprite != sprite) setSprite(sprite);
+        m_renderState.tint = tint;
+    }
+
 private:
     PowerUpType m_type;
 };
+
+// Fixed pool of power-ups of every type. All storage (the entities, the free list,
+// the pickup grid and the collected list) is allocated up front, sprites are shared
+// per type, and lifetimes run on the simulation clock, so spawning, expiring and
+// collecting never allocate or touch the disk. Pickups are looked up through a
+// uniform grid with intrusive per-cell lists, so a pickup test only visits the
+// cells under the collector.
+class PowerUpField {
+public:
+    static constexpr float CELL_SIZE = 64.0f;
+
+    explicit PowerUpField(int capacity = 256);
+    ~PowerUpField();
+
+    void setTimers(std::shared_ptr<TimerWheel> timers) { m_timers = std::move(timers); }
+    void setSprite(PowerUpType type, std::shared_ptr<GameSprite> sprite, const ofColor& tint = ofColor(255, 255, 255));
+    void resize(int width, int height); // the area covered by the pickup grid
+
+    // false when the pool is full
+    bool spawn(float x, float y, PowerUpType type, float lifetimeSeconds);
+    // types of every power-up whose circle overlaps the collector's; those are removed
+    const std::vector<PowerUpType>& collect(const Creature& collector);
+    void clear();
+    void draw() const;
+
+    int getActiveCount() const { return m_activeCount; }
+    int getCapacity() const { return static_cast<int>(m_slots.size()); }
+
+private:
+    static constexpr int NONE = -1;
+
+    struct Slot {
+        bool active = false;
+        int cell = NONE;
+        int prev = NONE; // neighbours in the cell list
+        int next = NONE;
+        TimerId expiry;
+    };
+
+    int cellOf(float x, float y) const;
+    void release(int index);
+
+    std::vector<PowerUp> m_powerUps;
+    std::vector<Slot> m_slots;
+    std::vector<int> m_free;
+    std::vector<int> m_cellHeads;
+    int m_columns = 0;
+    int m_rows = 0;
+    int m_activeCount = 0;
+    std::array<std::shared_ptr<GameSprite>, POWER_UP_TYPE_COUNT> m_sprites;
+    std::array<ofColor, POWER_UP_TYPE_COUNT> m_tints;
+    std::vector<PowerUpType> m_collected;
+    std::shared_ptr<TimerWheel> m_timers;
+};
@@ -0,0 +1,112 @@
+#include "Schooling.h"
+
+
+void SchoolingSystem::rebuild(const std::vector<Creature*>& creatures, float cellSize, float originX, float originY, int width, int height) {
+    m_cellSize = std::max(1.0f, cellSize);
+    m_originX = originX;
+    m_originY = originY;
+    m_columns = std::max(1, static_cast<int>(std::ceil(width / m_cellSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(height / m_cellSize)));
+    int cells = m_columns * m_rows;
+    int count = static_cast<int>(creatures.size());
+
+    m_cellStart.assign(cells + 1, 0);
+    m_cellOf.resize(count);
+    for (int i = 0; i < count; ++i) {
+        int column = std::min(m_columns - 1, std::max(0, static_cast<int>((creatures[i]->getCenterX() - m_originX) / m_cellSize)));
+        int row = std::min(m_rows - 1, std::max(0, static_cast<int>((creatures[i]->getCenterY() - m_originY) / m_cellSize)));
+        m_cellOf[i] = row * m_columns + column;
+        ++m_cellStart[m_cellOf[i] + 1];
+    }
+    for (int c = 0; c < cells; ++c) {
+        m_cellStart[c + 1] += m_cellStart[c];
+    }
+
+    // stable counting sort: creatures in the same cell keep their bucket order
+    m_order.resize(count);
+    m_x.resize(count); m_y.resize(count); m_dx.resize(count); m_dy.resize(count);
+    m_steerX.assign(count, 0.0f); m_steerY.assign(count, 0.0f);
+    m_cellCursor.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        int slot = m_cellCursor[m_cellOf[i]]++;
+        m_order[slot] = i;
+        m_x[slot] = creatures[i]->getCenterX();
+        m_y[slot] = creatures[i]->getCenterY();
+        m_dx[slot] = creatures[i]->getDx();
+        m_dy[slot] = creatures[i]->getDy();
+    }
+}
+
+void SchoolingSystem::computeSteering(int begin, int end, const SchoolingSettings& settings) {
+    float radiusSquared = settings.neighborRadius * settings.neighborRadius;
+    float separationSquared = settings.separationDistance * settings.separationDistance;
+    // own cell first, then the ring, always in the same order so the capped neighbor set is deterministic
+    const int offsets[9][2] = {{0, 0}, {-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+    for (int i = begin; i < end; ++i) {
+        int column = std::min(m_columns - 1, std::max(0, static_cast<int>((m_x[i] - m_originX) / m_cellSize)));
+        int row = std::min(m_rows - 1, std::max(0, static_cast<int>((m_y[i] - m_originY) / m_cellSize)));
+
+        float separationX = 0, separationY = 0, headingX = 0, headingY = 0, centerX = 0, centerY = 0;
+        int neighbors = 0;
+        for (const auto& offset : offsets) {
+            int c = column + offset[0], r = row + offset[1];
+            if (c < 0 || r < 0 || c >= m_columns || r >= m_rows) continue;
+            int cell = r * m_columns + c;
+            for (int j = m_cellStart[cell]; j < m_cellStart[cell + 1] && neighbors < settings.maxNeighbors; ++j) {
+                if (j == i) continue;
+                float dx = m_x[i] - m_x[j], dy = m_y[i] - m_y[j];
+                float distanceSquared = dx * dx + dy * dy;
+                if (distanceSquared > radiusSquared) continue;
+                if (distanceSquared < separationSquared && distanceSquared > 0.0f) {
+                    separationX += dx / distanceSquared;
+                    separationY += dy / distanceSquared;
+                }
+                headingX += m_dx[j];
+                headingY += m_dy[j];
+                centerX += m_x[j];
+                centerY += m_y[j];
+                ++neighbors;
+            }
+            if (neighbors >= settings.maxNeighbors) break;
+        }
+
+        if (neighbors == 0) {
+            m_steerX[i] = m_steerY[i] = 0.0f;
+            continue;
+        }
+        float toCenterX = centerX / neighbors - m_x[i], toCenterY = centerY / neighbors - m_y[i];
+        float toCenterLength = std::sqrt(toCenterX * toCenterX + toCenterY * toCenterY);
+        if (toCenterLength > 0.0f) {
+            toCenterX /= toCenterLength;
+            toCenterY /= toCenterLength;
+        }
+        m_steerX[i] = separationX * settings.separationDistance * settings.separationWeight
+            + (headingX / neighbors - m_dx[i]) * settings.alignmentWeight
+            + toCenterX * settings.cohesionWeight;
+        m_steerY[i] = separationY * settings.separationDistance * settings.separationWeight
+            + (headingY / neighbors - m_dy[i]) * settings.alignmentWeight
+            + toCenterY * settings.cohesionWeight;
+    }
+}
+
+void SchoolingSystem::update(const std::vector<Creature*>& creatures, const SchoolingSettings& settings,
+                             float originX, float originY, int width, int height, ThreadPool* pool) {
+    if (!settings.enabled || creatures.size() < 2) return;
+    rebuild(creatures, settings.neighborRadius, originX, originY, width, height);
+
+    int count = static_cast<int>(creatures.size());
+    const int chunk = 256;
+    int chunks = (count + chunk - 1) / chunk;
+    if (pool && chunks > 1) {
+        pool->parallelFor(chunks, [&](int k) {
+            computeSteering(k * chunk, std::min(count, (k + 1) * chunk), settings);
+        });
+    } else {
+        computeSteering(0, count, settings);
+    }
+
+    for (int slot = 0; slot < count; ++slot) {
+        creatures[m_order[slot]]->steer(m_steerX[slot], m_steerY[slot], 1.0f);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include "Core.h"
+#include "ThreadPool.h"
+
+
+// Boids tuning for one NPC type. The neighbor radius doubles as the cell size of
+// the grid, and maxNeighbors caps the work per creature no matter how dense a school gets.
+struct SchoolingSettings {
+    bool enabled = false;
+    float neighborRadius = 90.0f;
+    int maxNeighbors = 8;
+    float separationDistance = 35.0f;
+    float separationWeight = 0.6f;
+    float alignmentWeight = 0.25f;
+    float cohesionWeight = 0.15f;
+};
+
+// Separation/alignment/cohesion for a bucket of creatures. Every tick the creatures
+// are counting-sorted by grid cell into flat arrays, so each neighbor query walks
+// at most 3x3 contiguous cell ranges. Steering is computed from that snapshot into
+// per-creature slots and applied afterwards, so a parallel update gives the same
+// result as a serial one.
+class SchoolingSystem {
+public:
+    // the grid spans width x height world units from (originX, originY), the active part of the world
+    void update(const std::vector<Creature*>& creatures, const SchoolingSettings& settings,
+                float originX, float originY, int width, int height, ThreadPool* pool = nullptr);
+
+private:
+    void rebuild(const std::vector<Creature*>& creatures, float cellSize, float originX, float originY, int width, int height);
+    void computeSteering(int begin, int end, const SchoolingSettings& settings);
+
+    int m_columns = 0;
+    int m_rows = 0;
+    float m_cellSize = 1.0f;
+    float m_originX = 0.0f;
+    float m_originY = 0.0f;
+    std::vector<int> m_cellStart; // m_columns * m_rows + 1 prefix offsets into the sorted arrays
+    std::vector<int> m_cellOf;    // per input creature
+    std::vector<int> m_cellCursor; // next free slot per cell while sorting
+    std::vector<int> m_order;     // sorted slot -> input index
+    std::vector<float> m_x, m_y, m_dx, m_dy; // sorted snapshot (centers and headings)
+    std::vector<float> m_steerX, m_steerY;   // sorted output
+};
@@ -0,0 +1,342 @@
+#include "SoftwareRenderer.h"
+#include "Core.h"
+#include "WorldCamera.h"
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AQUARIUM_SOFTWARE_SSE2 1
+#endif
+
+
+static SoftwareFramebuffer* s_renderTarget = nullptr;
+static ofColor s_renderColor(255, 255, 255); // not ofColor::white, static init order across files is unspecified
+static SoftwareTransform s_transform;
+static std::vector<SoftwareTransform> s_transformStack;
+
+// 5x7 column-major glyphs (bit 0 is the top row) for the characters the HUD uses;
+// lowercase falls back to uppercase and anything else draws as a blank cell
+struct SoftwareGlyph {
+    char c;
+    uint8_t columns[5];
+};
+
+static const SoftwareGlyph s_glyphs[] = {
+    {'0', {0x3E, 0x51, 0x49, 0x45, 0x3E}}, {'1', {0x00, 0x42, 0x7F, 0x40, 0x00}},
+    {'2', {0x42, 0x61, 0x51, 0x49, 0x46}}, {'3', {0x21, 0x41, 0x45, 0x4B, 0x31}},
+    {'4', {0x18, 0x14, 0x12, 0x7F, 0x10}}, {'5', {0x27, 0x45, 0x45, 0x45, 0x39}},
+    {'6', {0x3C, 0x4A, 0x49, 0x49, 0x30}}, {'7', {0x01, 0x71, 0x09, 0x05, 0x03}},
+    {'8', {0x36, 0x49, 0x49, 0x49, 0x36}}, {'9', {0x06, 0x49, 0x49, 0x29, 0x1E}},
+    {'A', {0x7E, 0x11, 0x11, 0x11, 0x7E}}, {'B', {0x7F, 0x49, 0x49, 0x49, 0x36}},
+    {'C', {0x3E, 0x41, 0x41, 0x41, 0x22}}, {'D', {0x7F, 0x41, 0x41, 0x22, 0x1C}},
+    {'E', {0x7F, 0x49, 0x49, 0x49, 0x41}}, {'F', {0x7F, 0x09, 0x09, 0x09, 0x01}},
+    {'G', {0x3E, 0x41, 0x49, 0x49, 0x7A}}, {'H', {0x7F, 0x08, 0x08, 0x08, 0x7F}},
+    {'I', {0x00, 0x41, 0x7F, 0x41, 0x00}}, {'J', {0x20, 0x40, 0x41, 0x3F, 0x01}},
+    {'K', {0x7F, 0x08, 0x14, 0x22, 0x41}}, {'L', {0x7F, 0x40, 0x40, 0x40, 0x40}},
+    {'M', {0x7F, 0x02, 0x0C, 0x02, 0x7F}}, {'N', {0x7F, 0x04, 0x08, 0x10, 0x7F}},
+    {'O', {0x3E, 0x41, 0x41, 0x41, 0x3E}}, {'P', {0x7F, 0x09, 0x09, 0x09, 0x06}},
+    {'Q', {0x3E, 0x41, 0x51, 0x21, 0x5E}}, {'R', {0x7F, 0x09, 0x19, 0x29, 0x46}},
+    {'S', {0x46, 0x49, 0x49, 0x49, 0x31}}, {'T', {0x01, 0x01, 0x7F, 0x01, 0x01}},
+    {'U', {0x3F, 0x40, 0x40, 0x40, 0x3F}}, {'V', {0x1F, 0x20, 0x40, 0x20, 0x1F}},
+    {'W', {0x3F, 0x40, 0x38, 0x40, 0x3F}}, {'X', {0x63, 0x14, 0x08, 0x14, 0x63}},
+    {'Y', {0x07, 0x08, 0x70, 0x08, 0x07}}, {'Z', {0x61, 0x51, 0x49, 0x45, 0x43}},
+    {':', {0x00, 0x36, 0x36, 0x00, 0x00}}, {'!', {0x00, 0x00, 0x5F, 0x00, 0x00}},
+    {'.', {0x00, 0x60, 0x60, 0x00, 0x00}}, {'-', {0x08, 0x08, 0x08, 0x08, 0x08}},
+    {'/', {0x20, 0x10, 0x08, 0x04, 0x02}}, {'%', {0x23, 0x13, 0x08, 0x64, 0x62}},
+};
+
+static const uint8_t* FindGlyph(char c) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    for (const SoftwareGlyph& glyph : s_glyphs) {
+        if (glyph.c == c) return glyph.columns;
+    }
+    return nullptr;
+}
+
+// x / 255 rounded, exact for x in [0, 255 * 255]
+static inline int Div255(int x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+
+// SoftwareFramebuffer Implementation
+SoftwareFramebuffer::SoftwareFramebuffer(int width, int height)
+    : m_width(width), m_height(height), m_pixels(static_cast<size_t>(width) * height * 4, 0) {}
+
+void SoftwareFramebuffer::clear(const ofColor& color) {
+    for (size_t i = 0; i < m_pixels.size(); i += 4) {
+        m_pixels[i] = color.r;
+        m_pixels[i + 1] = color.g;
+        m_pixels[i + 2] = color.b;
+        m_pixels[i + 3] = color.a;
+    }
+}
+
+void SoftwareFramebuffer::blendPixel(uint8_t* dst, const uint8_t* src, int channels, const ofColor& tint) {
+    int alpha = channels == 4 ? Div255(src[3] * tint.a) : tint.a;
+    int inverse = 255 - alpha;
+    dst[0] = static_cast<uint8_t>(Div255(Div255(src[0] * tint.r) * alpha + dst[0] * inverse));
+    dst[1] = static_cast<uint8_t>(Div255(Div255(src[1] * tint.g) * alpha + dst[1] * inverse));
+    dst[2] = static_cast<uint8_t>(Div255(Div255(src[2] * tint.b) * alpha + dst[2] * inverse));
+    dst[3] = static_cast<uint8_t>(alpha + Div255(dst[3] * inverse));
+}
+
+#ifdef AQUARIUM_SOFTWARE_SSE2
+// four RGBA pixels at once: out = src * a + dst * (255 - a), with the source alpha
+// lane forced to 255 so the alpha channel comes out as a + dstA * (255 - a)
+static inline void BlendFourPixels(uint8_t* dst, const uint8_t* src) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i round = _mm_set1_epi16(128);
+    const __m128i alphaLane = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+    __m128i sOpaque = _mm_or_si128(s, alphaLane);
+
+    __m128i out[2];
+    for (int half = 0; half < 2; ++half) {
+        __m128i s16 = half == 0 ? _mm_unpacklo_epi8(s, zero) : _mm_unpackhi_epi8(s, zero);
+        __m128i c16 = half == 0 ? _mm_unpacklo_epi8(sOpaque, zero) : _mm_unpackhi_epi8(sOpaque, zero);
+        __m128i d16 = half == 0 ? _mm_unpacklo_epi8(d, zero) : _mm_unpackhi_epi8(d, zero);
+        __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i sum = _mm_add_epi16(_mm_mullo_epi16(c16, a), _mm_mullo_epi16(d16, _mm_sub_epi16(full, a)));
+        sum = _mm_add_epi16(sum, round);
+        out[half] = _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_epi16(sum, 8)), 8);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(out[0], out[1]));
+}
+#endif
+
+void SoftwareFramebuffer::blend(const uint8_t* src, int srcWidth, int srcHeight, int channels, int x, int y, const ofColor& tint) {
+    if (src == nullptr || channels < 3) return;
+    int x0 = std::max(0, x), y0 = std::max(0, y);
+    int x1 = std::min(m_width, x + srcWidth), y1 = std::min(m_height, y + srcHeight);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    bool plain = channels == 4 && tint.r == 255 && tint.g == 255 && tint.b == 255 && tint.a == 255;
+    for (int row = y0; row < y1; ++row) {
+        const uint8_t* s = src + (static_cast<size_t>(row - y) * srcWidth + (x0 - x)) * channels;
+        uint8_t* d = m_pixels.data() + (static_cast<size_t>(row) * m_width + x0) * 4;
+        int count = x1 - x0;
+        int i = 0;
+#ifdef AQUARIUM_SOFTWARE_SSE2
+        if (plain) {
+            for (; i + 4 <= count; i += 4) {
+                BlendFourPixels(d + i * 4, s + i * 4);
+            }
+        }
+#endif
+        for (; i < count; ++i) {
+            blendPixel(d + i * 4, s + i * channels, channels, tint);
+        }
+    }
+}
+
+void SoftwareFramebuffer::blendScaled(const uint8_t* src, int srcWidth, int srcHeight, int channels, float x, float y, float scale, const ofColor& tint) {
+    if (src == nullptr || channels < 3 || scale <= 0.0f) return;
+    int x0 = std::max(0, static_cast<int>(std::floor(x))), y0 = std::max(0, static_cast<int>(std::floor(y)));
+    int x1 = std::min(m_width, static_cast<int>(std::ceil(x + srcWidth * scale)));
+    int y1 = std::min(m_height, static_cast<int>(std::ceil(y + srcHeight * scale)));
+    float inverse = 1.0f / scale;
+    for (int row = y0; row < y1; ++row) {
+        int sy = static_cast<int>((row + 0.5f - y) * inverse); // the source pixel under this one's center
+        if (sy < 0 || sy >= srcHeight) continue;
+        const uint8_t* s = src + static_cast<size_t>(sy) * srcWidth * channels;
+        uint8_t* d = m_pixels.data() + static_cast<size_t>(row) * m_width * 4;
+        for (int col = x0; col < x1; ++col) {
+            int sx = static_cast<int>((col + 0.5f - x) * inverse);
+            if (sx < 0 || sx >= srcWidth) continue;
+            blendPixel(d + col * 4, s + sx * channels, channels, tint);
+        }
+    }
+}
+
+void SoftwareFramebuffer::fillCircle(float cx, float cy, float radius, const ofColor& color) {
+    int y0 = std::max(0, static_cast<int>(cy - radius)), y1 = std::min(m_height - 1, static_cast<int>(cy + radius));
+    uint8_t src[4] = {255, 255, 255, 255};
+    for (int row = y0; row <= y1; ++row) {
+        float dy = row + 0.5f - cy;
+        float span = radius * radius - dy * dy;
+        if (span < 0) continue;
+        span = std::sqrt(span);
+        int x0 = std::max(0, static_cast<int>(cx - span + 0.5f)), x1 = std::min(m_width - 1, static_cast<int>(cx + span - 0.5f));
+        for (int col = x0; col <= x1; ++col) {
+            blendPixel(m_pixels.data() + (static_cast<size_t>(row) * m_width + col) * 4, src, 4, color);
+        }
+    }
+}
+
+void SoftwareFramebuffer::drawText(const std::string& text, float x, float y, const ofColor& color, float scale) {
+    uint8_t src[4] = {255, 255, 255, 255};
+    float penX = x;
+    float top = y - 7 * scale;
+    for (char c : text) {
+        const uint8_t* columns = FindGlyph(c);
+        for (int col = 0; columns && col < 5; ++col) {
+            // every glyph pixel is at least one framebuffer pixel, so small scales stay legible
+            int px0 = static_cast<int>(std::floor(penX + col * scale));
+            int px1 = std::max(px0 + 1, static_cast<int>(std::floor(penX + (col + 1) * scale)));
+            for (int row = 0; row < 7; ++row) {
+                if ((columns[col] >> row & 1) == 0) continue;
+                int py0 = static_cast<int>(std::floor(top + row * scale));
+                int py1 = std::max(py0 + 1, static_cast<int>(std::floor(top + (row + 1) * scale)));
+                for (int py = std::max(0, py0); py < std::min(m_height, py1); ++py) {
+                    for (int px = std::max(0, px0); px < std::min(m_width, px1); ++px) {
+                        blendPixel(m_pixels.data() + (static_cast<size_t>(py) * m_width + px) * 4, src, 4, color);
+                    }
+                }
+            }
+        }
+        penX += 8 * scale; // same advance as ofDrawBitmapString
+    }
+}
+
+bool SoftwareFramebuffer::savePng(const std::string& path) const {
+    ofPixels pixels;
+    pixels.setFromPixels(m_pixels.data(), m_width, m_height, OF_IMAGE_COLOR_ALPHA);
+    return ofSaveImage(pixels, path);
+}
+
+bool SoftwareFramebuffer::loadPng(const std::string& path) {
+    ofPixels pixels;
+    if (!ofLoadImage(pixels, path) || pixels.getNumChannels() != 4
+        || static_cast<int>(pixels.getWidth()) != m_width || static_cast<int>(pixels.getHeight()) != m_height) {
+        return false;
+    }
+    std::memcpy(m_pixels.data(), pixels.getData(), m_pixels.size());
+    return true;
+}
+
+int SoftwareFramebuffer::countDifferingPixels(const SoftwareFramebuffer& other, int tolerance) const {
+    if (other.m_width != m_width || other.m_height != m_height) return m_width * m_height;
+    int differing = 0;
+    for (size_t i = 0; i < m_pixels.size(); i += 4) {
+        for (int c = 0; c < 4; ++c) {
+            if (std::abs(m_pixels[i + c] - other.m_pixels[i + c]) > tolerance) {
+                ++differing;
+                break;
+            }
+        }
+    }
+    return differing;
+}
+
+
+// render routing
+void SetSoftwareRenderTarget(SoftwareFramebuffer* target) { s_renderTarget = target; }
+SoftwareFramebuffer* GetSoftwareRenderTarget() { return s_renderTarget; }
+
+void RenderSetColor(const ofColor& color) {
+    s_renderColor = color;
+    if (!s_renderTarget) ofSetColor(color);
+}
+
+const ofColor& GetRenderColor() { return s_renderColor; }
+
+void RenderCircle(float x, float y, float radius) {
+    if (s_renderTarget) {
+        s_renderTarget->fillCircle(s_transform.x + x * s_transform.scale, s_transform.y + y * s_transform.scale,
+                                   radius * s_transform.scale, s_renderColor);
+    } else {
+        ofDrawCircle(x, y, radius);
+    }
+}
+
+void RenderText(const std::string& text, float x, float y) {
+    if (s_renderTarget) {
+        s_renderTarget->drawText(text, s_transform.x + x * s_transform.scale, s_transform.y + y * s_transform.scale,
+                                 s_renderColor, s_transform.scale);
+    } else {
+        ofDrawBitmapString(text, x, y);
+    }
+}
+
+void RenderPushMatrix() {
+    if (s_renderTarget) {
+        s_transformStack.push_back(s_transform);
+    } else {
+        ofPushMatrix();
+    }
+}
+
+void RenderPopMatrix() {
+    if (!s_renderTarget) {
+        ofPopMatrix();
+    } else if (!s_transformStack.empty()) {
+        s_transform = s_transformStack.back();
+        s_transformStack.pop_back();
+    }
+}
+
+void RenderTranslate(float x, float y) {
+    if (s_renderTarget) {
+        s_transform.x += x * s_transform.scale;
+        s_transform.y += y * s_transform.scale;
+    } else {
+        ofTranslate(x, y);
+    }
+}
+
+void RenderScale(float scale) {
+    if (s_renderTarget) {
+        s_transform.scale *= scale;
+    } else {
+        ofScale(scale, scale);
+    }
+}
+
+const SoftwareTransform& GetSoftwareTransform() { return s_transform; }
+
+void RenderSceneToFramebuffer(GameScene& scene, SoftwareFramebuffer& target, const WorldCamera* camera) {
+    SoftwareFramebuffer* previous = s_renderTarget;
+    SetSoftwareRenderTarget(&target);
+    s_transform = SoftwareTransform(); // every frame starts untransformed
+    s_transformStack.clear();
+    RenderSetColor(ofColor::white);
+    if (camera) camera->begin();
+    scene.Draw();
+    if (camera) camera->end();
+    SetSoftwareRenderTarget(previous);
+}
+
+void BenchmarkSoftwareRender(GameScene& scene, int width, int height, int frames, const WorldCamera* camera) {
+    SoftwareFramebuffer target(width, height);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        target.clear(ofColor::blue);
+        RenderSceneToFramebuffer(scene, target, camera);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ofLogNotice("render") << "software render of " << scene.GetName() << " at " << width << "x" << height
+        << ": " << (frames > 0 ? seconds / frames * 1000.0 : 0.0) << "ms/frame";
+}
+
+bool RunRenderTest(GameScene& scene, const WorldCamera* camera, int width, int height,
+                   const std::string& outPath, const std::string& referencePath) {
+    SoftwareFramebuffer frame(width, height);
+    frame.clear(ofColor::blue);
+    RenderSceneToFramebuffer(scene, frame, camera);
+    if (!frame.savePng(outPath)) {
+        ofLogError("render") << "could not save " << outPath;
+        return false;
+    }
+    ofLogNotice("render") << scene.GetName() << " at " << width << "x" << height << " saved to " << outPath;
+    if (referencePath.empty()) return true;
+
+    SoftwareFramebuffer reference(width, height);
+    if (!reference.loadPng(referencePath)) {
+        ofLogError("render") << referencePath << " is missing or not a " << width << "x" << height << " RGBA image";
+        return false;
+    }
+    int differing = frame.countDifferingPixels(reference, 2); // rounding slack for other compilers and SIMD paths
+    if (differing > 0) {
+        ofLogError("render") << differing << " pixels differ from " << referencePath;
+        return false;
+    }
+    ofLogNotice("render") << "matches " << referencePath;
+    return true;
+}
@@ -0,0 +1,75 @@
+#include "ThreadPool.h"
+
+
+ThreadPool::ThreadPool(unsigned int workers) {
+    if (workers == CALLER_ONLY) {
+        workers = 0;
+    } else if (workers == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        workers = cores > 1 ? cores - 1 : 0; // the caller is the last worker
+    }
+    for (unsigned int i = 0; i < workers; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) return;
+    if (m_workers.empty() || count == 1) {
+        for (int i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_jobCount = count;
+        m_nextIndex.store(0);
+        m_busyWorkers = static_cast<int>(m_workers.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_job = nullptr;
+}
+
+void ThreadPool::drain() {
+    int i;
+    while ((i = m_nextIndex.fetch_add(1)) < m_jobCount) {
+        (*m_job)(i);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    unsigned long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) return;
+            seen = m_generation;
+        }
+
+        drain();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0) {
+            m_done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+
+// Small fixed-size worker pool for data-parallel loops over independent items
+// (aquarium shards, environments). The calling thread helps drain the work too.
+class ThreadPool {
+public:
+    static constexpr unsigned int CALLER_ONLY = ~0u; // no workers, the caller runs every item
+
+    explicit ThreadPool(unsigned int workers = 0); // 0 picks one worker per spare core
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // runs fn(i) for every i in [0, count) and blocks until all of them returned
+    void parallelFor(int count, const std::function<void(int)>& fn);
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+private:
+    void workerLoop();
+    void drain();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(int)>* m_job = nullptr;
+    int m_jobCount = 0;
+    std::atomic<int> m_nextIndex{0};
+    int m_busyWorkers = 0;
+    unsigned long m_generation = 0;
+    bool m_stopping = false;
+};
@@ -0,0 +1,133 @@
+#include "TimerWheel.h"
+#include <cmath>
+
+
+TimerId TimerWheel::schedule(float delaySeconds, std::function<void()> callback) {
+    float ticks = std::ceil(std::max(0.0f, delaySeconds) / TICK_SECONDS - 1e-4f);
+    return scheduleTicks(static_cast<uint32_t>(std::max(1.0f, ticks)), std::move(callback));
+}
+
+TimerId TimerWheel::scheduleTicks(uint32_t ticks, std::function<void()> callback) {
+    if (!m_headsReady) {
+        m_heads.fill(NONE);
+        m_headsReady = true;
+    }
+    uint32_t index;
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    Node& node = m_nodes[index];
+    node.expiry = m_now + std::max<uint32_t>(1, ticks);
+    node.callback = std::move(callback);
+    insert(index);
+    ++m_pending;
+    return TimerId{index, node.generation};
+}
+
+bool TimerWheel::isPending(TimerId id) const {
+    return id.isValid() && id.index < m_nodes.size()
+        && m_nodes[id.index].generation == id.generation && m_nodes[id.index].slot >= 0;
+}
+
+bool TimerWheel::cancel(TimerId& id) {
+    bool pending = isPending(id);
+    if (pending) {
+        unlink(id.index);
+        release(id.index);
+    }
+    id = TimerId();
+    return pending;
+}
+
+float TimerWheel::getRemaining(TimerId id) const {
+    if (!isPending(id)) return 0.0f;
+    return (m_nodes[id.index].expiry - m_now) * TICK_SECONDS;
+}
+
+void TimerWheel::advance(float seconds) {
+    m_accumulator += seconds;
+    while (m_accumulator >= TICK_SECONDS) {
+        m_accumulator -= TICK_SECONDS;
+        tick();
+    }
+}
+
+void TimerWheel::advanceTicks(uint32_t ticks) {
+    for (uint32_t i = 0; i < ticks; ++i) {
+        tick();
+    }
+}
+
+void TimerWheel::tick() {
+    ++m_now;
+    if (!m_headsReady || m_pending == 0) return;
+
+    // when the lower levels wrap, pull the next slot of each upper level down,
+    // highest first so timers can fall through more than one level this tick
+    int top = 0;
+    while (top + 1 < LEVELS && (m_now & ((uint64_t(1) << (SLOT_BITS * (top + 1))) - 1)) == 0) {
+        ++top;
+    }
+    for (int level = top; level >= 1; --level) {
+        cascade(level);
+    }
+
+    uint32_t& head = m_heads[m_now & (SLOTS - 1)];
+    while (head != NONE) {
+        uint32_t index = head;
+        unlink(index);
+        std::function<void()> callback = std::move(m_nodes[index].callback);
+        release(index); // free first, so the callback may reschedule into this node
+        if (callback) callback();
+    }
+}
+
+void TimerWheel::cascade(int level) {
+    int slot = level * SLOTS + static_cast<int>((m_now >> (SLOT_BITS * level)) & (SLOTS - 1));
+    uint32_t index = m_heads[slot];
+    m_heads[slot] = NONE;
+    while (index != NONE) {
+        uint32_t next = m_nodes[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+void TimerWheel::insert(uint32_t index) {
+    Node& node = m_nodes[index];
+    uint64_t delta = node.expiry - m_now;
+    int level = 0;
+    while (level + 1 < LEVELS && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    uint64_t expiry = level + 1 == LEVELS ? std::min(node.expiry, m_now + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1) : node.expiry;
+    node.slot = level * SLOTS + static_cast<int>((expiry >> (SLOT_BITS * level)) & (SLOTS - 1));
+    node.prev = NONE;
+    node.next = m_heads[node.slot];
+    if (node.next != NONE) m_nodes[node.next].prev = index;
+    m_heads[node.slot] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = m_nodes[index];
+    if (node.prev != NONE) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        m_heads[node.slot] = node.next;
+    }
+    if (node.next != NONE) m_nodes[node.next].prev = node.prev;
+    node.next = node.prev = NONE;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& node = m_nodes[index];
+    node.slot = -1;
+    node.callback = nullptr;
+    ++node.generation;
+    m_free.push_back(index);
+    --m_pending;
+}
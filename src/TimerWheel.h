@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "ofMain.h"
+
+
+// Handle to a scheduled timer. Stale handles (fired, cancelled or reused) are
+// harmless: cancel() and isPending() just report false for them.
+struct TimerId {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+    bool isValid() const { return index != UINT32_MAX; }
+};
+
+// The simulation clock. Time advances in fixed ticks of TICK_SECONDS, and timed
+// effects (boosts, predator mode, damage debounce, pickup lifetimes, HUD messages)
+// are callbacks parked in a four-level hierarchical timing wheel: scheduling and
+// cancelling are O(1), and each tick only touches the slot that is due, so idle
+// timers cost nothing no matter how many are pending. Timers live in a pooled
+// node array; a steady population of effects allocates nothing after warm-up.
+class TimerWheel {
+public:
+    static constexpr float TICK_SECONDS = 1.0f / 60.0f;
+
+    TimerId schedule(float delaySeconds, std::function<void()> callback);
+    TimerId scheduleTicks(uint32_t ticks, std::function<void()> callback); // at least one tick out
+    bool cancel(TimerId& id); // also resets the handle
+    bool isPending(TimerId id) const;
+    float getRemaining(TimerId id) const; // seconds, 0 when not pending
+
+    // runs every tick that `seconds` completes; callbacks fire in expiry order
+    void advance(float seconds);
+    void advanceTicks(uint32_t ticks);
+
+    uint64_t getTick() const { return m_now; }
+    float getTime() const { return m_now * TICK_SECONDS; }
+    size_t getPendingCount() const { return m_pending; }
+
+private:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int LEVELS = 4; // 2^24 ticks, a little over three days at 60Hz
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        uint64_t expiry = 0;
+        uint32_t next = NONE;
+        uint32_t prev = NONE;
+        uint32_t generation = 0;
+        int slot = -1; // level * SLOTS + index, -1 when free
+        std::function<void()> callback;
+    };
+
+    void tick();
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level);
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_free;
+    std::array<uint32_t, LEVELS * SLOTS> m_heads;
+    uint64_t m_now = 0;
+    float m_accumulator = 0.0f;
+    size_t m_pending = 0;
+    bool m_headsReady = false;
+};
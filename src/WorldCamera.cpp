@@ -0,0 +1,57 @@
+#include "WorldCamera.h"
+#include "SoftwareRenderer.h"
+
+
+void WorldCamera::setViewSize(float width, float height) {
+    m_viewWidth = width;
+    m_viewHeight = height;
+    updateTransform();
+    lookAt(m_viewX + m_viewWidth * 0.5f, m_viewY + m_viewHeight * 0.5f);
+}
+
+void WorldCamera::setWorldSize(float width, float height) {
+    m_worldWidth = width;
+    m_worldHeight = height;
+    lookAt(m_viewX + m_viewWidth * 0.5f, m_viewY + m_viewHeight * 0.5f);
+}
+
+void WorldCamera::setViewport(int width, int height) {
+    m_viewportWidth = std::max(1, width);
+    m_viewportHeight = std::max(1, height);
+    updateTransform();
+}
+
+// a world smaller than the view stays pinned to its top-left corner
+void WorldCamera::lookAt(float x, float y) {
+    m_viewX = std::max(0.0f, std::min(x - m_viewWidth * 0.5f, m_worldWidth - m_viewWidth));
+    m_viewY = std::max(0.0f, std::min(y - m_viewHeight * 0.5f, m_worldHeight - m_viewHeight));
+}
+
+void WorldCamera::updateTransform() {
+    m_scale = std::min(m_viewportWidth / m_viewWidth, m_viewportHeight / m_viewHeight);
+    m_offsetX = (m_viewportWidth - m_viewWidth * m_scale) * 0.5f;
+    m_offsetY = (m_viewportHeight - m_viewHeight * m_scale) * 0.5f;
+}
+
+void WorldCamera::begin() const {
+    RenderPushMatrix();
+    RenderTranslate(m_offsetX, m_offsetY);
+    RenderScale(m_scale);
+}
+
+void WorldCamera::end() const {
+    RenderPopMatrix();
+}
+
+void WorldCamera::beginWorld() const {
+    RenderPushMatrix();
+    RenderTranslate(-m_viewX, -m_viewY);
+}
+
+void WorldCamera::endWorld() const {
+    RenderPopMatrix();
+}
+
+glm::vec2 WorldCamera::screenToWorld(float x, float y) const {
+    return glm::vec2((x - m_offsetX) / m_scale + m_viewX, (y - m_offsetY) / m_scale + m_viewY);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ofMain.h"
+
+
+// Maps a fixed logical view onto whatever window we have, and scrolls that view
+// over a world that can be many views wide. The simulation only ever sees world
+// units; the window size only changes the transform pushed here, so resizing costs
+// nothing and plays the same at any resolution. The view keeps its aspect ratio and
+// is letterboxed. The transforms go through RenderPushMatrix and friends, so software
+// frames (SoftwareRenderer.h) are placed the same way.
+class WorldCamera {
+public:
+    void setViewSize(float width, float height);  // logical screen, in world units
+    void setWorldSize(float width, float height); // how far the view can scroll
+    void setViewport(int width, int height); // window size, from windowResized
+    void lookAt(float x, float y); // centers the view on a world point, clamped to the world
+
+    void begin() const; // view units until end(): HUD, title screens
+    void end() const;
+    void beginWorld() const; // inside begin(): world units, scrolled to the view
+    void endWorld() const;
+
+    glm::vec2 screenToWorld(float x, float y) const;
+    float getViewX() const { return m_viewX; }
+    float getViewY() const { return m_viewY; }
+    float getViewWidth() const { return m_viewWidth; }
+    float getViewHeight() const { return m_viewHeight; }
+    float getWorldWidth() const { return m_worldWidth; }
+    float getWorldHeight() const { return m_worldHeight; }
+    float getScale() const { return m_scale; }
+
+private:
+    void updateTransform();
+
+    float m_viewWidth = 1024.0f;
+    float m_viewHeight = 768.0f;
+    float m_worldWidth = 1024.0f;
+    float m_worldHeight = 768.0f;
+    float m_viewX = 0.0f; // top-left of the view in the world
+    float m_viewY = 0.0f;
+    int m_viewportWidth = 1024;
+    int m_viewportHeight = 768;
+    float m_scale = 1.0f;
+    float m_offsetX = 0.0f;
+    float m_offsetY = 0.0f;
+};
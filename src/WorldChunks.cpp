@@ -0,0 +1,119 @@
+#include "WorldChunks.h"
+#include <algorithm>
+#include <cmath>
+
+
+void WorldChunks::resize(int worldWidth, int worldHeight) {
+    m_worldWidth = std::max(1, worldWidth);
+    m_worldHeight = std::max(1, worldHeight);
+    m_columns = (m_worldWidth + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    m_rows = (m_worldHeight + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    m_dormant.assign(static_cast<size_t>(m_columns) * m_rows, std::vector<DormantCreature>());
+    m_typeCounts.assign(m_typeCounts.size(), 0);
+    m_dormantCount = 0;
+    m_column0 = m_row0 = 0;
+    m_column1 = m_columns - 1;
+    m_row1 = m_rows - 1;
+}
+
+int WorldChunks::chunkColumn(float x) const {
+    return std::min(m_columns - 1, std::max(0, static_cast<int>(std::floor(x / CHUNK_SIZE))));
+}
+
+int WorldChunks::chunkRow(float y) const {
+    return std::min(m_rows - 1, std::max(0, static_cast<int>(std::floor(y / CHUNK_SIZE))));
+}
+
+bool WorldChunks::setView(float x, float y, float width, float height, int margin) {
+    int column0 = std::max(0, chunkColumn(x) - margin);
+    int row0 = std::max(0, chunkRow(y) - margin);
+    int column1 = std::min(m_columns - 1, chunkColumn(x + width) + margin);
+    int row1 = std::min(m_rows - 1, chunkRow(y + height) + margin);
+    if (column0 == m_column0 && row0 == m_row0 && column1 == m_column1 && row1 == m_row1) return false;
+    m_column0 = column0;
+    m_row0 = row0;
+    m_column1 = column1;
+    m_row1 = row1;
+    return true;
+}
+
+bool WorldChunks::isActive(float x, float y) const {
+    int column = chunkColumn(x), row = chunkRow(y);
+    return column >= m_column0 && column <= m_column1 && row >= m_row0 && row <= m_row1;
+}
+
+void WorldChunks::store(const DormantCreature& creature) {
+    std::vector<DormantCreature>& records = m_dormant[chunkRow(creature.y) * m_columns + chunkColumn(creature.x)];
+    if (records.size() >= MAX_PER_CHUNK) {
+        forget(records.front()); // records stay in store order, so the front is the oldest
+        records.erase(records.begin());
+    }
+    records.push_back(creature);
+    records.back().sequence = ++m_sequence;
+    if (creature.type >= m_typeCounts.size()) m_typeCounts.resize(creature.type + 1, 0);
+    ++m_typeCounts[creature.type];
+    ++m_dormantCount;
+}
+
+void WorldChunks::forget(const DormantCreature& creature) {
+    --m_typeCounts[creature.type];
+    --m_dormantCount;
+}
+
+// only runs past the limit, and every record counts against one, so the scans stay short
+void WorldChunks::trimType(uint8_t type, size_t limit) {
+    while (getDormantCount(type) > limit) {
+        std::vector<DormantCreature>* oldestChunk = nullptr;
+        size_t oldest = 0;
+        for (std::vector<DormantCreature>& records : m_dormant) {
+            for (size_t i = 0; i < records.size(); ++i) {
+                if (records[i].type != type) continue;
+                if (!oldestChunk || records[i].sequence < (*oldestChunk)[oldest].sequence) {
+                    oldestChunk = &records;
+                    oldest = i;
+                }
+                break; // the first of its type in a chunk is that chunk's oldest
+            }
+        }
+        forget((*oldestChunk)[oldest]);
+        oldestChunk->erase(oldestChunk->begin() + oldest);
+        if (oldestChunk->empty()) std::vector<DormantCreature>().swap(*oldestChunk);
+    }
+}
+
+void WorldChunks::takeActive(std::vector<DormantCreature>& out, const std::function<bool(const DormantCreature&)>& wake) {
+    for (int row = m_row0; row <= m_row1; ++row) {
+        for (int column = m_column0; column <= m_column1; ++column) {
+            std::vector<DormantCreature>& records = m_dormant[row * m_columns + column];
+            if (records.empty()) continue;
+            // records that stay keep their order, so the front is still the oldest
+            size_t kept = 0;
+            for (size_t i = 0; i < records.size(); ++i) {
+                if (wake(records[i])) {
+                    out.push_back(records[i]);
+                    forget(records[i]);
+                } else {
+                    records[kept++] = records[i];
+                }
+            }
+            records.resize(kept);
+            if (records.empty()) std::vector<DormantCreature>().swap(records); // a woken chunk holds no memory
+        }
+    }
+}
+
+void WorldChunks::clear() {
+    for (auto& records : m_dormant) {
+        std::vector<DormantCreature>().swap(records);
+    }
+    m_typeCounts.assign(m_typeCounts.size(), 0);
+    m_dormantCount = 0;
+}
+
+float WorldChunks::getActiveWidth() const {
+    return std::min(static_cast<float>(m_worldWidth), (m_column1 + 1) * static_cast<float>(CHUNK_SIZE)) - getActiveX();
+}
+
+float WorldChunks::getActiveHeight() const {
+    return std::min(static_cast<float>(m_worldHeight), (m_row1 + 1) * static_cast<float>(CHUNK_SIZE)) - getActiveY();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+
+// Everything needed to rebuild a paged-out NPC where it was, heading the same way.
+// Sprites, masks and behavior state come back from the type when it wakes up.
+struct DormantCreature {
+    float x = 0.0f; // hitbox center
+    float y = 0.0f;
+    float dx = 0.0f;
+    float dy = 0.0f;
+    int16_t speed = 0;
+    uint8_t type = 0; // AquariumCreatureType
+    uint32_t sequence = 0; // store order, set by WorldChunks; the oldest records are dropped first
+};
+
+// Splits the world into fixed-size chunks. The chunks around the camera are active:
+// their creatures are real, simulated and drawn. Every other chunk only keeps the
+// DormantCreature records of whatever was left there, so memory and CPU follow the
+// view rather than the size of the world. Until setView is called everything is active.
+// Records are capped per chunk and, through trimType, per type, so a long session that
+// keeps paging creatures out does not keep growing.
+class WorldChunks {
+public:
+    static constexpr int CHUNK_SIZE = 512;
+    static constexpr size_t MAX_PER_CHUNK = 32; // a full chunk drops its oldest record
+
+    void resize(int worldWidth, int worldHeight);
+    // activates the chunks under the view plus `margin` chunks around it;
+    // returns true when that set changed
+    bool setView(float x, float y, float width, float height, int margin = 1);
+    bool isActive(float x, float y) const;
+
+    void store(const DormantCreature& creature); // into the chunk under its center
+    // drops the oldest records of `type` until at most `limit` are left
+    void trimType(uint8_t type, size_t limit);
+    // moves the records of the active chunks that `wake` accepts into `out`, ready to be
+    // rebuilt; the rest stay where they are
+    void takeActive(std::vector<DormantCreature>& out, const std::function<bool(const DormantCreature&)>& wake);
+    void clear(); // forgets every dormant creature
+
+    // the active chunks as a world-space rectangle
+    float getActiveX() const { return m_column0 * static_cast<float>(CHUNK_SIZE); }
+    float getActiveY() const { return m_row0 * static_cast<float>(CHUNK_SIZE); }
+    float getActiveWidth() const;
+    float getActiveHeight() const;
+    int getActiveChunkCount() const { return (m_column1 - m_column0 + 1) * (m_row1 - m_row0 + 1); }
+    int getChunkCount() const { return m_columns * m_rows; }
+    size_t getDormantCount() const { return m_dormantCount; }
+    size_t getDormantCount(uint8_t type) const { return type < m_typeCounts.size() ? m_typeCounts[type] : 0; }
+
+private:
+    int chunkColumn(float x) const;
+    int chunkRow(float y) const;
+    void forget(const DormantCreature& creature); // count bookkeeping for a record leaving
+
+    int m_worldWidth = 0;
+    int m_worldHeight = 0;
+    int m_columns = 1;
+    int m_rows = 1;
+    int m_column0 = 0, m_row0 = 0, m_column1 = 0, m_row1 = 0; // inclusive active range
+    std::vector<std::vector<DormantCreature>> m_dormant; // per chunk, row-major
+    size_t m_dormantCount = 0;
+    std::vector<size_t> m_typeCounts; // indexed by type
+    uint32_t m_sequence = 0;
+};
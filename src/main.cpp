@@ -1,8 +1,128 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "AquariumServer.h"
+#include "AquariumEnv.h"
 
 //========================================================================
-int main( ){
+// --autoplay [speed]   the autoplayer plays, speed simulation ticks per frame
+// --soak [seconds]     the same without a window, as fast as one core allows
+//                      (0 runs until killed); samples go to soak.csv
+// --env-bench <envs> <steps>
+//                      step that many training environments with random actions and
+//                      report steps per second
+// --behavior-bench <creatures> [ticks]
+//                      time creature movement through virtual move() against the
+//                      per-type buckets, and a full moveCreatures tick
+// --shards <count>     log how ticking that many headless tanks scales over 1, 2, 4...
+//                      threads, then run them in the window; tab cycles the one drawn
+// --flight [file]      print a flight recording (default data/flight.bin) and exit
+// --render-test <intro|game|game-over> <out.png> [reference.png]
+//                      draw one frame of the scene with the software renderer, no
+//                      window; with a reference, exit 1 unless the two match
+//                      (scripts/render-test.sh checks all three against bin/data/render-reference)
+// --render-bench [frames]
+//                      time software frames of each scene (default 300 frames)
+// --server-load <bots> [seconds] [--udp] [--loss p]
+//                      bot clients against one headless server (default 30 s over
+//                      in-process loopback, p the fraction of datagrams dropped)
+int main(int argc, char* argv[]){
+	bool autoplay = false;
+	int autoplaySpeed = 1;
+	int shardCount = 0;
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc && argv[i + 1][0] != '-';
+		if (arg == "--soak") {
+			SoakConfig config;
+			if (hasValue) config.seconds = std::stof(argv[++i]);
+			config.csvPath = ofToDataPath("soak.csv");
+			ofSetLogLevel(OF_LOG_WARNING); // the game rules log every sting
+			ofSetLogLevel("soak", OF_LOG_NOTICE);
+			ofSetLogLevel("memory", OF_LOG_NOTICE);
+			SoakSample last = RunAutoplaySoak(config);
+			ofLogNotice("soak") << "done: " << last.ticks << " ticks, level " << last.level << ", peak rss " << last.peakResidentBytes / 1024 << "KB";
+			LogMemoryReport();
+			return 0;
+		}
+		if (arg == "--server-load") {
+			int bots = hasValue ? std::stoi(argv[++i]) : 16;
+			int seconds = i + 1 < argc && argv[i + 1][0] != '-' ? std::stoi(argv[++i]) : 30;
+			bool useUdp = false;
+			float loss = 0.0f;
+			for (++i; i < argc; ++i) {
+				string option = argv[i];
+				if (option == "--udp") useUdp = true;
+				else if (option == "--loss" && i + 1 < argc) loss = std::stof(argv[++i]);
+			}
+			ofSetLogLevel(OF_LOG_WARNING); // respawns and the game rules log on every tick
+			ofSetLogLevel("server", OF_LOG_NOTICE);
+			RunServerLoadTest(bots, seconds, useUdp, loss);
+			return 0;
+		}
+		if (arg == "--env-bench") {
+			int envs = hasValue ? std::stoi(argv[++i]) : 64;
+			int steps = i + 1 < argc && argv[i + 1][0] != '-' ? std::stoi(argv[++i]) : 1000;
+			ofSetLogLevel(OF_LOG_WARNING);
+			ofSetLogLevel("env", OF_LOG_NOTICE);
+			RunEnvBenchmark(envs, steps);
+			return 0;
+		}
+		if (arg == "--behavior-bench") {
+			int creatures = hasValue ? std::stoi(argv[++i]) : 50000;
+			int ticks = i + 1 < argc && argv[i + 1][0] != '-' ? std::stoi(argv[++i]) : 200;
+			ofSetLogLevel(OF_LOG_WARNING);
+			ofSetLogLevel("behavior", OF_LOG_NOTICE);
+			BenchmarkCreatureBehaviors(creatures, ticks);
+			return 0;
+		}
+		if (arg == "--render-test") {
+			if (i + 2 >= argc) {
+				ofLogError("render") << "usage: --render-test <intro|game|game-over> <out.png> [reference.png]";
+				return 1;
+			}
+			string name = argv[++i];
+			string outPath = argv[++i];
+			string referencePath = i + 1 < argc && argv[i + 1][0] != '-' ? string(argv[++i]) : "";
+			GameSprite::setUseTextures(false); // no window, so no GL context
+			ofSetLogLevel(OF_LOG_WARNING);
+			ofSetLogLevel("render", OF_LOG_NOTICE);
+			WorldCamera camera;
+			std::shared_ptr<GameScene> scene = MakeHeadlessScene(name, camera);
+			if (!scene) {
+				ofLogError("render") << "unknown scene " << name;
+				return 1;
+			}
+			int width = static_cast<int>(camera.getViewWidth()), height = static_cast<int>(camera.getViewHeight());
+			return RunRenderTest(*scene, &camera, width, height, outPath, referencePath) ? 0 : 1;
+		}
+		if (arg == "--render-bench") {
+			int frames = hasValue ? std::stoi(argv[++i]) : 300;
+			GameSprite::setUseTextures(false);
+			ofSetLogLevel(OF_LOG_WARNING);
+			ofSetLogLevel("render", OF_LOG_NOTICE);
+			for (const char* name : {"intro", "game", "game-over"}) {
+				WorldCamera camera;
+				std::shared_ptr<GameScene> scene = MakeHeadlessScene(name, camera);
+				BenchmarkSoftwareRender(*scene, static_cast<int>(camera.getViewWidth()), static_cast<int>(camera.getViewHeight()), frames, &camera);
+			}
+			return 0;
+		}
+		if (arg == "--flight") {
+			string path = hasValue ? string(argv[++i]) : ofToDataPath("flight.bin");
+			return LogFlightRecording(path) ? 0 : 1;
+		}
+		if (arg == "--shards") {
+			shardCount = hasValue ? std::max(1, std::stoi(argv[++i])) : 8;
+			ofSetLogLevel(OF_LOG_WARNING);
+			ofSetLogLevel("shards", OF_LOG_NOTICE);
+			RunShardScaling(shardCount, 1800); // 30 simulated seconds per run
+			ofSetLogLevel(OF_LOG_NOTICE);
+		}
+		if (arg == "--autoplay") {
+			autoplay = true;
+			if (hasValue) autoplaySpeed = std::max(1, std::stoi(argv[++i]));
+		}
+	}
 
 	//Use ofGLFWWindowSettings for more options like multi-monitor fullscreen
 	ofGLWindowSettings settings;
@@ -11,7 +131,11 @@ int main( ){
 
 	auto window = ofCreateWindow(settings);
 
-	ofRunApp(window, std::make_shared<ofApp>());
+	auto app = std::make_shared<ofApp>();
+	app->autoplay = autoplay;
+	app->autoplaySpeed = autoplaySpeed;
+	app->shardCount = shardCount;
+	ofRunApp(window, app);
 	ofRunMainLoop();
 
 }
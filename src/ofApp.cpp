@@ -1,18 +1,42 @@
 #include "ofApp.h"
+#ifdef TARGET_GLFW_WINDOW
+#include "ofAppGLFWWindow.h"
+#endif
 
 //--------------------------------------------------------------
 void ofApp::setup(){
+    startupBegin = std::chrono::steady_clock::now();
 
+    // GL_TEXTURE_2D rather than rectangle textures, which cannot have mipmaps; must come
+    // before any image, FBO or font is loaded
+    ofDisableArbTex();
     ofSetFrameRate(60);
     ofSetBackgroundColor(ofColor::blue);
-    backgroundImage.load("background.png");
-    backgroundImage.resize(ofGetWindowWidth(), ofGetWindowHeight());
-
-    // New: load and loop background music ===
-    backgroundMusic.load("background_loop.wav"); 
-    backgroundMusic.setLoop(true);               
-    backgroundMusic.setVolume(0.5f);            
-    backgroundMusic.play();
+    {
+        MemoryScope memory(MemoryTag::SPRITES);
+        ofPixels backgroundPixels;
+        if (LoadCookedPixels("background.png", 0, 0, backgroundPixels)) {
+            backgroundImage.setFromPixels(backgroundPixels);
+            backgroundImage.getTexture().generateMipmap(); // minified smoothly in small windows
+            backgroundImage.getTexture().setTextureMinMagFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+            TrackGpuMemory(MemoryTag::SPRITES, EstimateTextureBytes(backgroundPixels.getWidth(), backgroundPixels.getHeight(), true)); // lives as long as the app
+        }
+    }
+    camera.setViewSize(VIEW_WIDTH, VIEW_HEIGHT);
+    camera.setWorldSize(WORLD_WIDTH, WORLD_HEIGHT);
+    camera.setViewport(ofGetWindowWidth(), ofGetWindowHeight());
+
+    // stream the background music from disk and mix event effects on the audio thread,
+    // falling back to the null backend when there is no sound device
+    audio = std::make_shared<AudioSystem>();
+    audio->loadEffect(SoundEffect::EAT, "sfx-eat.wav");
+    audio->loadEffect(SoundEffect::STING, "sfx-sting.wav");
+    audio->loadEffect(SoundEffect::POWER_UP, "sfx-powerup.wav");
+    audio->loadEffect(SoundEffect::LEVEL_UP, "sfx-levelup.wav");
+    if (!audio->setup(std::make_unique<SoundStreamAudioBackend>())) {
+        audio->setup(std::make_unique<NullAudioBackend>());
+    }
+    audio->streamBackground("background_loop.wav", 0.5f);
 
     std::shared_ptr<Aquarium> myAquarium;
     std::shared_ptr<PlayerCreature> player;
@@ -24,48 +48,64 @@ void ofApp::setup(){
     // first we make the intro scene 
     gameManager->AddScene(std::make_shared<GameIntroScene>(
         GameSceneKindToString(GameSceneKind::GAME_INTRO),
-        std::make_shared<GameSprite>("title.png", ofGetWindowWidth(), ofGetWindowHeight())
+        std::make_shared<GameSprite>("title.png", VIEW_WIDTH, VIEW_HEIGHT)
     ));
 
     //AquariumSpriteManager
     spriteManager = std::make_shared<AquariumSpriteManager>();
 
     // Lets setup the aquarium
-    myAquarium = std::make_shared<Aquarium>(ofGetWindowWidth(), ofGetWindowHeight(), spriteManager);
-    player = std::make_shared<PlayerCreature>(ofGetWindowWidth()/2 - 50, ofGetWindowHeight()/2 - 50, DEFAULT_SPEED, this->spriteManager->GetSprite(AquariumCreatureType::NPCreature));
+    myAquarium = std::make_shared<Aquarium>(WORLD_WIDTH, WORLD_HEIGHT, spriteManager);
+    player = std::make_shared<PlayerCreature>(WORLD_WIDTH/2 - 50, WORLD_HEIGHT/2 - 50, DEFAULT_SPEED, this->spriteManager->GetSprite(AquariumCreatureType::NPCreature));
     player->setDirection(0, 0); // Initially stationary
-    player->setBounds(ofGetWindowWidth() - 20, ofGetWindowHeight() - 20);
+    player->setBounds(WORLD_WIDTH - 20, WORLD_HEIGHT - 20);
 
 
-    myAquarium->addAquariumLevel(std::make_shared<Level_0>(0, 10));
-    myAquarium->addAquariumLevel(std::make_shared<Level_1>(1, 30));
-    myAquarium->addAquariumLevel(std::make_shared<Level_2>(2, 60));
-    myAquarium->addAquariumLevel(std::make_shared<Level_3>(3, 120));
-    myAquarium->addAquariumLevel(std::make_shared<Level_4>(4, 240));
+    AddDefaultAquariumLevels(myAquarium);
     myAquarium->Repopulate(); // initial population
 
     // now that we are mostly set, lets pass the player and the aquarium downstream
-    gameManager->AddScene(std::make_shared<AquariumGameScene>(
+    auto aquariumScene = std::make_shared<AquariumGameScene>(
         std::move(player), std::move(myAquarium), GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)
-    )); // player and aquarium are owned by the scene moving forward
-
-    // Load font for game over message
-    gameOverTitle.load("Verdana.ttf", 12, true, true);
-    gameOverTitle.setLineHeight(34.0f);
-    gameOverTitle.setLetterSpacing(1.035);
-
+    ); // player and aquarium are owned by the scene moving forward
+    aquariumScene->SetAudioSystem(audio);
+    aquariumScene->SetCamera(&camera);
+    if (flightRecorder.open(ofToDataPath("flight.bin"))) aquariumScene->SetFlightRecorder(&flightRecorder);
+    if (!autoplay) aquariumScene->SetInput(&input); // the autoplayer steers instead
+    gameManager->AddScene(aquariumScene);
 
     gameManager->AddScene(std::make_shared<GameOverScene>(
         GameSceneKindToString(GameSceneKind::GAME_OVER),
-        std::make_shared<GameSprite>("game-over.png", ofGetWindowWidth(), ofGetWindowHeight())
+        std::make_shared<GameSprite>("game-over.png", VIEW_WIDTH, VIEW_HEIGHT)
     ));
 
     ofSetLogLevel(OF_LOG_NOTICE); // Set default log level
+    if (shardCount > 0) {
+        shardHost = std::make_unique<AquariumHost>(shardCount, VIEW_WIDTH, VIEW_HEIGHT, 1, 0, spriteManager);
+    }
+    if (autoplay) {
+        soakMonitor = std::make_unique<SoakMonitor>(60.0f, ofToDataPath("soak.csv"));
+        ofLogNotice() << "autoplay at " << autoplaySpeed << "x, samples in " << ofToDataPath("soak.csv");
+    }
+
+    const AssetCacheStats& assets = GetAssetCacheStats();
+    ofLogNotice() << "cold start: setup " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count()
+        << "ms, images " << assets.seconds * 1000.0 << "ms (" << assets.hits << " cached, " << assets.misses << " cooked)";
 }
 
 //--------------------------------------------------------------
 void ofApp::update(){
-    
+    if (shardHost) {
+        shardHost->tick();
+        return;
+    }
+    if (autoplay) {
+        updateAutoplay();
+        return;
+    }
+    if (isIdle() && !idleFrameScene.empty()) {
+        waitForInput(); // key handlers run in here and may leave the scene
+    }
     if(gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::GAME_OVER)){
         return; // Stop updating if game is over or exiting
     }
@@ -85,15 +125,119 @@ void ofApp::update(){
 
 }
 
+// several simulation ticks per frame; each advances the clock by a whole frame, so
+// timed effects last as many ticks as they would at normal speed
+void ofApp::updateAutoplay(){
+    if(gameManager->GetActiveSceneName() != GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)){
+        gameManager->Transition(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)); // past the title
+    }
+    auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetActiveScene());
+    for (int i = 0; i < autoplaySpeed; ++i) {
+        autoPlayer.steer(*gameScene->GetAquarium(), *gameScene->GetPlayer());
+        auto tickStart = std::chrono::steady_clock::now();
+        gameManager->UpdateActiveScene();
+        soakMonitor->recordTick(ofGetLastFrameTime(), std::chrono::duration<double>(std::chrono::steady_clock::now() - tickStart).count());
+        if (gameScene->GetLastEvent() != nullptr && gameScene->GetLastEvent()->isGameOver()) {
+            soakMonitor->recordGameOver();
+            gameScene->Restart();
+        }
+    }
+    soakMonitor->poll(*gameScene->GetAquarium(), *gameScene->GetPlayer());
+}
+
 //--------------------------------------------------------------
 void ofApp::draw(){
-    backgroundImage.draw(0, 0);
+    if (!firstFrameReported) {
+        firstFrameReported = true;
+        ofLogNotice() << "cold start: first frame after " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count() << "ms";
+    }
+    if (shardHost) {
+        ofBackground(0);
+        camera.begin(); // each shard is one view in size
+        shardHost->drawSelected();
+        camera.end();
+        return;
+    }
+    if (!isIdle()) {
+        idleFrameScene.clear();
+        drawFrame();
+        return;
+    }
+    if (idleFrameScene != gameManager->GetActiveSceneName()) {
+        if (idleFrame.getWidth() != ofGetWidth() || idleFrame.getHeight() != ofGetHeight()) {
+            MemoryScope memory(MemoryTag::SPRITES);
+            if (idleFrame.isAllocated()) TrackGpuMemory(MemoryTag::SPRITES, -EstimateTextureBytes(idleFrame.getWidth(), idleFrame.getHeight(), false));
+            idleFrame.allocate(ofGetWidth(), ofGetHeight(), GL_RGBA);
+            TrackGpuMemory(MemoryTag::SPRITES, EstimateTextureBytes(ofGetWidth(), ofGetHeight(), false));
+        }
+        idleFrame.begin();
+        drawFrame();
+        idleFrame.end();
+        idleFrameScene = gameManager->GetActiveSceneName();
+    }
+    ofSetColor(ofColor::white);
+    idleFrame.draw(0, 0);
+}
+
+void ofApp::drawFrame(){
+    bool drawBackground = true;
+    if(gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)){
+        auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetActiveScene());
+        drawBackground = gameScene->GetGovernor().getSettings().drawBackground; // dropped at the lowest quality
+    }
+    ofBackground(0); // letterbox bars
+    camera.begin();
+    if(drawBackground){
+        camera.beginWorld();
+        drawBackgroundTiles();
+        camera.endWorld();
+    }else{
+        ofSetColor(10, 40, 80);
+        ofDrawRectangle(0, 0, VIEW_WIDTH, VIEW_HEIGHT);
+        ofSetColor(ofColor::white);
+    }
     gameManager->DrawActiveScene();
+    if(autoplay){
+        ofDrawBitmapString("AUTOPLAY " + std::to_string(autoplaySpeed) + "x", 10, VIEW_HEIGHT - 10);
+    }
+    camera.end();
+}
+
+bool ofApp::isIdle(){
+    return !autoplay && !shardHost && gameManager->GetActiveScene() != nullptr && gameManager->GetActiveScene()->IsStatic();
+}
+
+void ofApp::waitForInput(){
+#ifdef TARGET_GLFW_WINDOW
+    glfwWaitEventsTimeout(0.5); // the timeout keeps the window answering the OS
+#else
+    ofSleepMillis(50); // no way to block on input here, poll at 20 Hz instead
+#endif
+}
+
+// the backdrop is one screen-sized image repeated over the world, every other copy
+// mirrored so the edges meet seamlessly; only the tiles under the view are drawn
+void ofApp::drawBackgroundTiles() const {
+    int column0 = static_cast<int>(camera.getViewX()) / VIEW_WIDTH;
+    int row0 = static_cast<int>(camera.getViewY()) / VIEW_HEIGHT;
+    int column1 = static_cast<int>(camera.getViewX() + camera.getViewWidth() - 1) / VIEW_WIDTH;
+    int row1 = static_cast<int>(camera.getViewY() + camera.getViewHeight() - 1) / VIEW_HEIGHT;
+    for (int row = row0; row <= row1; ++row) {
+        for (int column = column0; column <= column1; ++column) {
+            float x = column * VIEW_WIDTH, y = row * VIEW_HEIGHT;
+            float w = VIEW_WIDTH, h = VIEW_HEIGHT;
+            if (column % 2) { x += w; w = -w; }
+            if (row % 2) { y += h; h = -h; }
+            backgroundImage.draw(x, y, w, h);
+        }
+    }
 }
 
 //--------------------------------------------------------------
 void ofApp::exit(){
-    
+    LogMemoryReport();
+    LogInputLatency(input.getLatency());
+    audio->close();
 }
 
 //--------------------------------------------------------------
@@ -102,30 +246,24 @@ void ofApp::keyPressed(int key){
         ofLogNotice() << "Game has ended. Press ESC to exit." << std::endl;
         return; // Ignore other keys after game over
     }
+    if (key == 'M') { // high-water marks per subsystem
+        LogMemoryReport();
+        return;
+    }
+    if (shardHost) {
+        int count = shardHost->getShardCount();
+        if (key == OF_KEY_TAB || key == OF_KEY_RIGHT) shardHost->selectShard((shardHost->getSelectedShard() + 1) % count);
+        if (key == OF_KEY_LEFT) shardHost->selectShard((shardHost->getSelectedShard() + count - 1) % count);
+        if (key == 's') shardHost->logStats();
+        return;
+    }
     if(gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)){
         auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetActiveScene());
-        switch(key){
-            case OF_KEY_UP:
-                gameScene->GetPlayer()->setDirection(gameScene->GetPlayer()->isXDirectionActive()?gameScene->GetPlayer()->getDx():0, -1);
-                break;
-                case OF_KEY_DOWN:
-                gameScene->GetPlayer()->setDirection(gameScene->GetPlayer()->isXDirectionActive()?gameScene->GetPlayer()->getDx():0, 1);
-                break;
-            case OF_KEY_LEFT:
-                gameScene->GetPlayer()->setDirection(-1, gameScene->GetPlayer()->isYDirectionActive()?gameScene->GetPlayer()->getDy():0);
-                gameScene->GetPlayer()->setFlipped(true);
-                break;
-                case OF_KEY_RIGHT:
-                gameScene->GetPlayer()->setDirection(1, gameScene->GetPlayer()->isYDirectionActive()?gameScene->GetPlayer()->getDy():0);
-                gameScene->GetPlayer()->setFlipped(false);
-                break;
-            default:
-                break;
+        if (key == 'm') {
+            gameScene->ToggleMemoryHud();
+            return;
         }
-    
-        
-    
-        gameScene->GetPlayer()->move();
+        input.push(key, true); // the player moves on the next tick
         return;
 
     }
@@ -149,21 +287,7 @@ void ofApp::keyPressed(int key){
 
 //--------------------------------------------------------------
 void ofApp::keyReleased(int key){
-    if(gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)){
-        auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetActiveScene());
-    if( key == OF_KEY_UP || key == OF_KEY_DOWN){
-        gameScene->GetPlayer()->setDirection(gameScene->GetPlayer()->isXDirectionActive()?gameScene->GetPlayer()->getDx():0, 0);
-        gameScene->GetPlayer()->move();
-        return;
-    }
-    
-    if(key == OF_KEY_LEFT || key == OF_KEY_RIGHT){
-        gameScene->GetPlayer()->setDirection(0, gameScene->GetPlayer()->isYDirectionActive()?gameScene->GetPlayer()->getDy():0);
-        gameScene->GetPlayer()->move();
-        return;
-    }
-
-    }
+    input.push(key, false); // in any scene, so no key stays held across a transition
 }
 
 //--------------------------------------------------------------
@@ -203,10 +327,8 @@ void ofApp::mouseExited(int x, int y){
 
 //--------------------------------------------------------------
 void ofApp::windowResized(int w, int h){
-    backgroundImage.resize(w, h);
-    auto aquariumScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetScene(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)));
-    aquariumScene->GetAquarium()->setBounds(w,h);
-    aquariumScene->GetPlayer()->setBounds(w - 20, h - 20);
+    camera.setViewport(w, h); // the world itself does not change size
+    idleFrameScene.clear();
 
 }
 
@@ -2,6 +2,13 @@
 
 #include "ofMain.h"
 #include "Aquarium.h"
+#include "WorldCamera.h"
+#include "AssetCache.h"
+#include "AutoPlayer.h"
+#include "FlightRecorder.h"
+#include "InputQueue.h"
+#include "AquariumHost.h"
+#include <chrono>
 
 
 class ofApp : public ofBaseApp{
@@ -28,19 +35,57 @@ class ofApp : public ofBaseApp{
 		
 		char moveDirection;
 		int DEFAULT_SPEED = 5;
+		// the logical screen; the window only scales it (see WorldCamera)
+		int VIEW_WIDTH = 1024;
+		int VIEW_HEIGHT = 768;
+		// the camera follows the player across a world of several screens
+		int WORLD_WIDTH = 6 * 1024;
+		int WORLD_HEIGHT = 3 * 768;
 
 
 		AwaitFrames acuariumUpdate{5};
 
-		ofTrueTypeFont gameOverTitle;
 		GameEvent lastEvent;
 
 
-		ofImage backgroundImage;
+		ofImage backgroundImage; // kept at its own resolution, scaled by the camera
+		WorldCamera camera;
+		void drawBackgroundTiles() const;
+		void drawFrame();
+
+		// static scenes (title, game over) are drawn once into idleFrame and presented
+		// from it; between frames the loop waits for input instead of spinning at 60 fps
+		ofFbo idleFrame;
+		string idleFrameScene; // the scene idleFrame holds, empty when it must be redrawn
+		bool isIdle();
+		void waitForInput();
 
 		std::unique_ptr<GameSceneManager> gameManager;
 		std::shared_ptr<AquariumSpriteManager>spriteManager;
 		
-		// === New: background music player ===
-        ofSoundPlayer backgroundMusic;
+		// streamed background music and event sound effects
+		std::shared_ptr<AudioSystem> audio;
+
+		// soak runs: the autoplayer drives the player at autoplaySpeed ticks per frame,
+		// restarts after game overs and samples memory and tick times (see main.cpp)
+		bool autoplay = false;
+		int autoplaySpeed = 1;
+		AutoPlayer autoPlayer;
+		std::unique_ptr<SoakMonitor> soakMonitor;
+		void updateAutoplay();
+
+		// --shards: the app ticks shardCount headless tanks instead of the game and draws
+		// one of them; tab and the arrow keys pick which, 's' logs their stats
+		int shardCount = 0;
+		std::unique_ptr<AquariumHost> shardHost;
+
+		// arrow keys, applied by the game scene at the start of each tick
+		InputQueue input;
+
+		// the last 30 seconds of frames, kept in a mapped file that outlives a crash
+		FlightRecorder flightRecorder;
+
+		// cold-start reporting
+		std::chrono::steady_clock::time_point startupBegin;
+		bool firstFrameReported = false;
 };